@@ -0,0 +1,119 @@
+/*
+  Ethereal is a UCI chess playing engine authored by Andrew Grant.
+  <https://github.com/AndyGrant/Ethereal>     <andrew@grantnet.us>
+
+  Ethereal is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Ethereal is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include <stdint.h>
+#include <string.h>
+
+#include "attackmap.h"
+#include "attacks.h"
+#include "bitboards.h"
+#include "board.h"
+#include "move.h"
+#include "types.h"
+
+#ifdef USE_ATTACK_MAPS
+
+static uint64_t pieceAttacks(Board *board, int sq, uint64_t occupied) {
+
+    const int piece = board->squares[sq];
+
+    switch (pieceType(piece)) {
+        case PAWN   : return pawnAttacks(pieceColour(piece), sq);
+        case KNIGHT : return knightAttacks(sq);
+        case BISHOP : return bishopAttacks(sq, occupied);
+        case ROOK   : return rookAttacks(sq, occupied);
+        case QUEEN  : return queenAttacks(sq, occupied);
+        case KING   : return kingAttacks(sq);
+        default     : return 0ull;
+    }
+}
+
+static void setAttacks(AttackMap *map, int sq, uint64_t attacks) {
+
+    // Only the squares which gained or lost this attacker are touched
+    uint64_t changes = map->attacks[sq] ^ attacks;
+
+    map->attacks[sq] = attacks;
+    while (changes)
+        map->attackers[poplsb(&changes)] ^= 1ull << sq;
+}
+
+void refreshAttackMap(Board *board) {
+
+    uint64_t occupied = board->colours[WHITE] | board->colours[BLACK];
+
+    memset(&board->attackmap, 0, sizeof(AttackMap));
+
+    while (occupied) {
+        int sq = poplsb(&occupied);
+        setAttacks(&board->attackmap, sq, pieceAttacks(board, sq, board->colours[WHITE] | board->colours[BLACK]));
+    }
+}
+
+void updateAttackMap(Board *board, uint64_t changed) {
+
+    // A slider's attacks can only change if one of its rays reached one of
+    // the changed squares, either before or after the change. Any slider
+    // which reaches a changed square only after the change must have had
+    // that ray stopped by another changed square before, so the attackers
+    // of the changed squares, which are not yet updated, cover every case
+
+    AttackMap *const map = &board->attackmap;
+
+    const uint64_t occupied = board->colours[WHITE] | board->colours[BLACK];
+    const uint64_t sliders  = board->pieces[BISHOP] | board->pieces[ROOK] | board->pieces[QUEEN];
+
+    uint64_t update = changed, squares = changed;
+
+    while (squares)
+        update |= map->attackers[poplsb(&squares)] & sliders;
+
+    while (update) {
+        int sq = poplsb(&update);
+        setAttacks(map, sq, pieceAttacks(board, sq, occupied));
+    }
+}
+
+uint64_t attackMapChanges(uint16_t move) {
+
+    // Squares whose contents are changed by the move. The Pawn taken
+    // en passant sits directly behind the destination square
+
+    const int from = MoveFrom(move), to = MoveTo(move);
+
+    uint64_t changed = (1ull << from) | (1ull << to);
+
+    if (MoveType(move) == CASTLE_MOVE)
+        changed |= (1ull << castleKingTo(from, to)) | (1ull << castleRookTo(from, to));
+
+    if (MoveType(move) == ENPASS_MOVE)
+        changed |= 1ull << (to ^ 8);
+
+    return changed;
+}
+
+uint64_t attackMapAttacksFrom(Board *board, int sq) {
+    return board->attackmap.attacks[sq];
+}
+
+uint64_t attackMapAttackersTo(Board *board, int sq) {
+    return board->attackmap.attackers[sq];
+}
+
+#endif
@@ -0,0 +1,41 @@
+/*
+  Ethereal is a UCI chess playing engine authored by Andrew Grant.
+  <https://github.com/AndyGrant/Ethereal>     <andrew@grantnet.us>
+
+  Ethereal is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Ethereal is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <stdint.h>
+
+#include "types.h"
+
+// When built with USE_ATTACK_MAPS, each Board carries the attacks of the
+// piece on every square, and the set of pieces attacking every square.
+// Both are updated incrementally after the Board changes, by recomputing
+// the pieces on the changed squares and any sliders whose rays met them
+
+struct AttackMap {
+    uint64_t attacks[SQUARE_NB];
+    uint64_t attackers[SQUARE_NB];
+};
+
+void refreshAttackMap(Board *board);
+void updateAttackMap(Board *board, uint64_t changed);
+uint64_t attackMapChanges(uint16_t move);
+
+uint64_t attackMapAttacksFrom(Board *board, int sq);
+uint64_t attackMapAttackersTo(Board *board, int sq);
@@ -17,26 +17,57 @@
 */
 
 #include <assert.h>
+#include <inttypes.h>
 #include <stdint.h>
 
 #ifdef USE_PEXT
 #include <immintrin.h>
 #endif
 
+#include "attackmap.h"
 #include "attacks.h"
 #include "bitboards.h"
 #include "board.h"
+#include "cpu.h"
+#include "masks.h"
+#include "tablegen.h"
 #include "types.h"
 
+#if defined(USE_PRECOMPUTED)
+    #include "precomputed/attacks.h"
+#else
+
 ALIGN64 uint64_t PawnAttacks[COLOUR_NB][SQUARE_NB];
 ALIGN64 uint64_t KnightAttacks[SQUARE_NB];
+ALIGN64 uint64_t KingAttacks[SQUARE_NB];
+
+#if defined(USE_HYPERBOLA)
+
+ALIGN64 uint64_t LineMasks[SQUARE_NB][4]; // File, Diagonal, Anti-Diagonal
+ALIGN64 uint8_t RankAttacks[FILE_NB][64]; // Indexed by the six inner files
+
+#elif defined(USE_COMPRESSED_PEXT)
+
+ALIGN64 uint16_t BishopAttacks[0x1480];
+ALIGN64 uint16_t RookAttacks[0x19000];
+
+ALIGN64 Magic BishopTable[SQUARE_NB];
+ALIGN64 Magic RookTable[SQUARE_NB];
+
+#else
+
 ALIGN64 uint64_t BishopAttacks[0x1480];
 ALIGN64 uint64_t RookAttacks[0x19000];
-ALIGN64 uint64_t KingAttacks[SQUARE_NB];
 
 ALIGN64 Magic BishopTable[SQUARE_NB];
 ALIGN64 Magic RookTable[SQUARE_NB];
 
+#endif
+
+#endif
+
+#if !defined(USE_PRECOMPUTED)
+
 static int validCoordinate(int rank, int file) {
     return 0 <= rank && rank < RANK_NB
         && 0 <= file && file < FILE_NB;
@@ -47,14 +78,6 @@ static void setSquare(uint64_t *bb, int rank, int file) {
         *bb |= 1ull << square(rank, file);
 }
 
-static int sliderIndex(uint64_t occupied, Magic *table) {
-#ifdef USE_PEXT
-    return _pext_u64(occupied, table->mask);
-#else
-    return ((occupied & table->mask) * table->magic) >> table->shift;
-#endif
-}
-
 static uint64_t sliderAttacks(int sq, uint64_t occupied, const int delta[4][2]) {
 
     int rank, file, dr, df;
@@ -74,6 +97,74 @@ static uint64_t sliderAttacks(int sq, uint64_t occupied, const int delta[4][2])
     return result;
 }
 
+#endif
+
+#if defined(USE_HYPERBOLA)
+
+static uint64_t lineAttacks(int sq, uint64_t occupied, uint64_t mask) {
+
+    // Subtracting the slider from the blockers flips every bit up to and
+    // including the first blocker. Byte swapping mirrors the board, so
+    // that the same trick finds the first blocker in the other direction
+
+    uint64_t forward = occupied & mask;
+    uint64_t reverse = __builtin_bswap64(forward);
+
+    forward -= 1ull << sq;
+    reverse -= __builtin_bswap64(1ull << sq);
+
+    return (forward ^ __builtin_bswap64(reverse)) & mask;
+}
+
+static uint64_t rankAttacks(int sq, uint64_t occupied) {
+    const int shift = sq & ~7; // Square of the rank's A-File
+    return (uint64_t) RankAttacks[fileOf(sq)][(occupied >> (shift + 1)) & 63] << shift;
+}
+
+#if !defined(USE_PRECOMPUTED)
+
+static void initHyperbolaMasks(int sq, const int bishopDelta[4][2], const int rookDelta[4][2]) {
+
+    uint64_t bishop = sliderAttacks(sq, 0, bishopDelta);
+    uint64_t rook   = sliderAttacks(sq, 0, rookDelta);
+
+    // Split the empty board attacks into the three lines
+    LineMasks[sq][0] = rook & Files[fileOf(sq)];
+
+    while (bishop) {
+        int other = poplsb(&bishop);
+        int index = (rankOf(other) - rankOf(sq)) == (fileOf(other) - fileOf(sq)) ? 1 : 2;
+        setBit(&LineMasks[sq][index], other);
+    }
+
+    // Byte swapping does not mirror within a rank, so a tiny
+    // table, taken from the first rank, covers the Rook's rank
+    if (rankOf(sq) == 0)
+        for (int index = 0; index < 64; index++)
+            RankAttacks[sq][index] = sliderAttacks(sq, (uint64_t) index << 1, rookDelta) & RANK_1;
+}
+
+#endif
+
+#else
+
+static int sliderIndex(uint64_t occupied, const Magic *table) {
+#if defined(USE_PEXT)
+    return _pext_u64(occupied, table->mask);
+#elif defined(USE_DISPATCH)
+    if (CPUPext) {
+        uint64_t index;
+        asm ("pextq %2, %1, %0" : "=r" (index) : "r" (occupied), "rm" (table->mask));
+        return index;
+    }
+    return ((occupied & table->mask) * table->magic) >> table->shift;
+#else
+    return ((occupied & table->mask) * table->magic) >> table->shift;
+#endif
+}
+
+#if !defined(USE_PRECOMPUTED)
+
 static void initSliderAttacks(int sq, Magic *table, uint64_t magic, const int delta[4][2]) {
 
     uint64_t edges = ((RANK_1 | RANK_8) & ~Ranks[rankOf(sq)])
@@ -82,9 +173,16 @@ static void initSliderAttacks(int sq, Magic *table, uint64_t magic, const int de
     uint64_t occupied = 0ull;
 
     // Init entry for the given square
+    table[sq].mask = sliderAttacks(sq, 0, delta) & ~edges;
+
+#ifdef USE_COMPRESSED_PEXT
+    // Attack sets are stored as the subset of the empty board attacks
+    table[sq].attacks = sliderAttacks(sq, 0, delta);
+    (void) magic;
+#else
     table[sq].magic = magic;
-    table[sq].mask  = sliderAttacks(sq, 0, delta) & ~edges;
     table[sq].shift = 64 - popcount(table[sq].mask);
+#endif
 
     // Track the offset as we use up the table
     if (sq != SQUARE_NB - 1)
@@ -92,11 +190,26 @@ static void initSliderAttacks(int sq, Magic *table, uint64_t magic, const int de
 
     do { // Init attacks for all occupancy variations
         int index = sliderIndex(occupied, &table[sq]);
+#ifdef USE_COMPRESSED_PEXT
+        table[sq].offset[index] = _pext_u64(sliderAttacks(sq, occupied, delta), table[sq].attacks);
+#else
         table[sq].offset[index] = sliderAttacks(sq, occupied, delta);
+#endif
         occupied = (occupied - table[sq].mask) & table[sq].mask;
     } while (occupied);
 }
 
+#endif
+
+#endif
+
+#if defined(USE_PRECOMPUTED)
+
+void initAttacks() {
+    // Tables were written out when building
+}
+
+#else
 
 void initAttacks() {
 
@@ -106,10 +219,6 @@ void initAttacks() {
     const int BishopDelta[4][2] = {{-1,-1}, {-1, 1}, { 1,-1}, { 1, 1}};
     const int RookDelta[4][2]   = {{-1, 0}, { 0,-1}, { 0, 1}, { 1, 0}};
 
-    // First square has initial offset
-    BishopTable[0].offset = BishopAttacks;
-    RookTable[0].offset = RookAttacks;
-
     // Init attack tables for Pawns
     for (int sq = 0; sq < 64; sq++) {
         for (int dir = 0; dir < 2; dir++) {
@@ -126,11 +235,75 @@ void initAttacks() {
         }
     }
 
+#if defined(USE_HYPERBOLA)
+
+    // Init line masks for sliding pieces
+    for (int sq = 0; sq < 64; sq++)
+        initHyperbolaMasks(sq, BishopDelta, RookDelta);
+
+#else
+
+    // First square has initial offset
+    BishopTable[0].offset = BishopAttacks;
+    RookTable[0].offset = RookAttacks;
+
     // Init attack tables for sliding pieces
     for (int sq = 0; sq < 64; sq++) {
         initSliderAttacks(sq, BishopTable, BishopMagics[sq], BishopDelta);
         initSliderAttacks(sq,   RookTable,   RookMagics[sq],   RookDelta);
     }
+
+#endif
+}
+
+#endif
+
+#if !defined(USE_HYPERBOLA)
+
+static void writeMagicTable(FILE *fout, const char *name, const char *attacks, const Magic *table, const void *base) {
+
+    // Offsets are written relative to the start of the attack table,
+    // since the address itself is only known once the tables are linked
+
+    fprintf(fout, "ALIGN64 const Magic %s[SQUARE_NB] = {\n", name);
+
+    for (int sq = 0; sq < SQUARE_NB; sq++) {
+#ifdef USE_COMPRESSED_PEXT
+        fprintf(fout, "    { 0x%016"PRIx64"ull, 0x%016"PRIx64"ull, %s + %d },\n",
+            table[sq].mask, table[sq].attacks, attacks, (int) (table[sq].offset - (const uint16_t *) base));
+#else
+        fprintf(fout, "    { 0x%016"PRIx64"ull, 0x%016"PRIx64"ull, %d, %s + %d },\n",
+            table[sq].magic, table[sq].mask, (int) table[sq].shift, attacks, (int) (table[sq].offset - (const uint64_t *) base));
+#endif
+    }
+
+    fprintf(fout, "};\n\n");
+}
+
+#endif
+
+void writeAttackTables(FILE *fout) {
+
+    writeTable(fout, "ALIGN64 const uint64_t PawnAttacks", PawnAttacks, TABLE_U64, 2, COLOUR_NB, SQUARE_NB);
+    writeTable(fout, "ALIGN64 const uint64_t KnightAttacks", KnightAttacks, TABLE_U64, 1, SQUARE_NB);
+    writeTable(fout, "ALIGN64 const uint64_t KingAttacks", KingAttacks, TABLE_U64, 1, SQUARE_NB);
+
+#if defined(USE_HYPERBOLA)
+    writeTable(fout, "ALIGN64 const uint64_t LineMasks", LineMasks, TABLE_U64, 2, SQUARE_NB, 4);
+    writeTable(fout, "ALIGN64 const uint8_t RankAttacks", RankAttacks, TABLE_U8, 2, FILE_NB, 64);
+#else
+    const int type = sizeof(BishopAttacks[0]) == sizeof(uint16_t) ? TABLE_U16 : TABLE_U64;
+    const char *decl = type == TABLE_U16 ? "ALIGN64 const uint16_t" : "ALIGN64 const uint64_t";
+    char name[64];
+
+    snprintf(name, sizeof(name), "%s BishopAttacks", decl);
+    writeTable(fout, name, BishopAttacks, type, 1, 0x1480);
+    snprintf(name, sizeof(name), "%s RookAttacks", decl);
+    writeTable(fout, name, RookAttacks, type, 1, 0x19000);
+
+    writeMagicTable(fout, "BishopTable", "BishopAttacks", BishopTable, BishopAttacks);
+    writeMagicTable(fout, "RookTable", "RookAttacks", RookTable, RookAttacks);
+#endif
 }
 
 uint64_t pawnAttacks(int colour, int sq) {
@@ -146,12 +319,26 @@ uint64_t knightAttacks(int sq) {
 
 uint64_t bishopAttacks(int sq, uint64_t occupied) {
     assert(0 <= sq && sq < SQUARE_NB);
+#if defined(USE_HYPERBOLA)
+    return lineAttacks(sq, occupied, LineMasks[sq][1])
+         | lineAttacks(sq, occupied, LineMasks[sq][2]);
+#elif defined(USE_COMPRESSED_PEXT)
+    return _pdep_u64(BishopTable[sq].offset[sliderIndex(occupied, &BishopTable[sq])], BishopTable[sq].attacks);
+#else
     return BishopTable[sq].offset[sliderIndex(occupied, &BishopTable[sq])];
+#endif
 }
 
 uint64_t rookAttacks(int sq, uint64_t occupied) {
     assert(0 <= sq && sq < SQUARE_NB);
+#if defined(USE_HYPERBOLA)
+    return lineAttacks(sq, occupied, LineMasks[sq][0])
+         | rankAttacks(sq, occupied);
+#elif defined(USE_COMPRESSED_PEXT)
+    return _pdep_u64(RookTable[sq].offset[sliderIndex(occupied, &RookTable[sq])], RookTable[sq].attacks);
+#else
     return RookTable[sq].offset[sliderIndex(occupied, &RookTable[sq])];
+#endif
 }
 
 uint64_t queenAttacks(int sq, uint64_t occupied) {
@@ -165,16 +352,6 @@ uint64_t kingAttacks(int sq) {
 }
 
 
-uint64_t pawnLeftAttacks(uint64_t pawns, uint64_t targets, int colour) {
-    return targets & (colour == WHITE ? (pawns << 7) & ~FILE_H
-                                      : (pawns >> 7) & ~FILE_A);
-}
-
-uint64_t pawnRightAttacks(uint64_t pawns, uint64_t targets, int colour) {
-    return targets & (colour == WHITE ? (pawns << 9) & ~FILE_A
-                                      : (pawns >> 9) & ~FILE_H);
-}
-
 uint64_t pawnAttackSpan(uint64_t pawns, uint64_t targets, int colour) {
     return pawnLeftAttacks(pawns, targets, colour)
         | pawnRightAttacks(pawns, targets, colour);
@@ -185,10 +362,6 @@ uint64_t pawnAttackDouble(uint64_t pawns, uint64_t targets, int colour) {
         & pawnRightAttacks(pawns, targets, colour);
 }
 
-uint64_t pawnAdvance(uint64_t pawns, uint64_t occupied, int colour) {
-    return ~occupied & (colour == WHITE ? (pawns << 8) : (pawns >> 8));
-}
-
 uint64_t pawnEnpassCaptures(uint64_t pawns, int epsq, int colour) {
     return epsq == -1 ? 0ull : pawnAttacks(!colour, epsq) & pawns;
 }
@@ -196,18 +369,26 @@ uint64_t pawnEnpassCaptures(uint64_t pawns, int epsq, int colour) {
 
 int squareIsAttacked(Board *board, int colour, int sq) {
 
-    uint64_t enemy    = board->colours[!colour];
-    uint64_t occupied = board->colours[ colour] | enemy;
+#ifdef USE_ATTACK_MAPS
+    return (attackMapAttackersTo(board, sq) & board->colours[!colour]) != 0ull;
+#else
+    return squareIsAttackedThrough(board, colour, sq, board->colours[WHITE] | board->colours[BLACK]);
+#endif
+}
+
+int squareIsAttackedThrough(Board *board, int colour, int sq, uint64_t occupied) {
 
+    uint64_t enemy        = board->colours[!colour];
     uint64_t enemyPawns   = enemy &  board->pieces[PAWN  ];
     uint64_t enemyKnights = enemy &  board->pieces[KNIGHT];
     uint64_t enemyBishops = enemy & (board->pieces[BISHOP] | board->pieces[QUEEN]);
     uint64_t enemyRooks   = enemy & (board->pieces[ROOK  ] | board->pieces[QUEEN]);
     uint64_t enemyKings   = enemy &  board->pieces[KING  ];
 
-    // Check for attacks to this square. While this function has the same
-    // result as using attackersToSquare(board, colour, sq) != 0ull, this
-    // has a better running time by avoiding some slider move lookups. The
+    // Check for attacks to this square, given an occupancy which may differ
+    // from the board's, such as when the King has been lifted off of it. While
+    // this function has the same result as using attackersToSquare() != 0ull,
+    // this has a better running time by avoiding some slider move lookups. The
     // speed gain is easily proven using the provided PERFT suite
 
     return (pawnAttacks(colour, sq) & enemyPawns)
@@ -236,8 +417,39 @@ uint64_t attackersToKingSquare(Board *board) {
 
     // Wrapper for allAttackersToSquare() for use in check detection
     int kingsq = getlsb(board->colours[board->turn] & board->pieces[KING]);
+
+#ifdef USE_ATTACK_MAPS
+    return attackMapAttackersTo(board, kingsq) & board->colours[!board->turn];
+#else
     uint64_t occupied = board->colours[WHITE] | board->colours[BLACK];
     return allAttackersToSquare(board, occupied, kingsq) & board->colours[!board->turn];
+#endif
+}
+
+uint64_t pinnedPieces(Board *board, int colour) {
+
+    // Find the enemy sliders which would attack our King if our own pieces
+    // were removed. Any such slider with exactly one piece between it and
+    // our King is pinning that piece, when the piece is one of our own
+
+    uint64_t friendly = board->colours[ colour];
+    uint64_t enemy    = board->colours[!colour];
+    uint64_t occupied = friendly | enemy;
+    uint64_t pinned   = 0ull;
+
+    int kingsq = getlsb(friendly & board->pieces[KING]);
+
+    uint64_t sliders = (bishopAttacks(kingsq, enemy) & (board->pieces[BISHOP] | board->pieces[QUEEN]))
+                     | (  rookAttacks(kingsq, enemy) & (board->pieces[ROOK  ] | board->pieces[QUEEN]));
+
+    sliders &= enemy;
+
+    while (sliders) {
+        uint64_t between = bitsBetweenMasks(kingsq, poplsb(&sliders)) & occupied;
+        if (onlyOne(between)) pinned |= between & friendly;
+    }
+
+    return pinned;
 }
 
 uint64_t discoveredAttacks(Board *board, int sq, int US) {
@@ -20,15 +20,61 @@
 
 #include <stdint.h>
 
+#include "bitboards.h"
+#include "cpu.h"
 #include "types.h"
 
+// Bishop and Rook attacks come from one of three back ends, chosen when
+// building. Fancy Magics are the default. PEXT indexes with _pext_u64().
+// Optionally, PEXT stores each attack set compressed to 16 bits, to be
+// scattered back over the empty board attacks with _pdep_u64(), which
+// quarters the table at the cost of the extra latency. Hyperbola
+// Quintessence needs no occupancy tables at all, only a few masks per
+// square. Builds which dispatch at runtime share one table between PEXT
+// and Magics
+
+#if defined(USE_COMPRESSED_PEXT) && !defined(USE_PEXT)
+    #error "USE_COMPRESSED_PEXT requires USE_PEXT"
+#endif
+
+#if defined(USE_HYPERBOLA)
+    #define SLIDER_BACKEND "Hyperbola"
+#elif defined(USE_COMPRESSED_PEXT)
+    #define SLIDER_BACKEND "PEXT (Compressed)"
+#elif defined(USE_PEXT)
+    #define SLIDER_BACKEND "PEXT"
+#elif defined(USE_DISPATCH)
+    #define SLIDER_BACKEND (CPUPext ? "PEXT" : "Magic")
+#else
+    #define SLIDER_BACKEND "Magic"
+#endif
+
+// Dispatched builds lay the slider tables out for whichever of PEXT or
+// Magics the CPU supports, so there is no single table to write out
+
+#if defined(USE_DISPATCH) && defined(USE_PRECOMPUTED)
+    #error "USE_PRECOMPUTED cannot be combined with USE_DISPATCH"
+#endif
+
+#ifdef USE_COMPRESSED_PEXT
+
+struct Magic {
+    uint64_t mask;
+    uint64_t attacks;
+    TABLE uint16_t *offset;
+};
+
+#else
+
 struct Magic {
     uint64_t magic;
     uint64_t mask;
     uint64_t shift;
-    uint64_t *offset;
+    TABLE uint64_t *offset;
 };
 
+#endif
+
 void initAttacks();
 
 uint64_t pawnAttacks(int colour, int sq);
@@ -38,20 +84,35 @@ uint64_t rookAttacks(int sq, uint64_t occupied);
 uint64_t queenAttacks(int sq, uint64_t occupied);
 uint64_t kingAttacks(int sq);
 
-uint64_t pawnLeftAttacks(uint64_t pawns, uint64_t targets, int colour);
-uint64_t pawnRightAttacks(uint64_t pawns, uint64_t targets, int colour);
 uint64_t pawnAttackSpan(uint64_t pawns, uint64_t targets, int colour);
 uint64_t pawnAttackDouble(uint64_t pawns, uint64_t targets, int colour);
-uint64_t pawnAdvance(uint64_t pawns, uint64_t occupied, int colour);
 uint64_t pawnEnpassCaptures(uint64_t pawns, int epsq, int colour);
 
 int squareIsAttacked(Board *board, int colour, int sq);
+int squareIsAttackedThrough(Board *board, int colour, int sq, uint64_t occupied);
 uint64_t attackersToSquare(Board *board, int colour, int sq);
 uint64_t allAttackersToSquare(Board *board, uint64_t occupied, int sq);
 uint64_t attackersToKingSquare(Board *board);
+uint64_t pinnedPieces(Board *board, int colour);
 
 uint64_t discoveredAttacks(Board *board, int sq, int US);
 
+// The Pawn shifts live here so that a constant colour folds away
+
+INLINE uint64_t pawnLeftAttacks(uint64_t pawns, uint64_t targets, int colour) {
+    return targets & (colour == WHITE ? (pawns << 7) & ~FILE_H
+                                      : (pawns >> 7) & ~FILE_A);
+}
+
+INLINE uint64_t pawnRightAttacks(uint64_t pawns, uint64_t targets, int colour) {
+    return targets & (colour == WHITE ? (pawns << 9) & ~FILE_A
+                                      : (pawns >> 9) & ~FILE_H);
+}
+
+INLINE uint64_t pawnAdvance(uint64_t pawns, uint64_t occupied, int colour) {
+    return ~occupied & (colour == WHITE ? (pawns << 8) : (pawns >> 8));
+}
+
 static const uint64_t RookMagics[SQUARE_NB] = {
     0xA180022080400230ull, 0x0040100040022000ull, 0x0080088020001002ull, 0x0080080280841000ull,
     0x4200042010460008ull, 0x04800A0003040080ull, 0x0400110082041008ull, 0x008000A041000880ull,
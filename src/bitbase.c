@@ -0,0 +1,605 @@
+/*
+  Ethereal is a UCI chess playing engine authored by Andrew Grant.
+  <https://github.com/AndyGrant/Ethereal>     <andrew@grantnet.us>
+
+  Ethereal is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Ethereal is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "attacks.h"
+#include "bitbase.h"
+#include "bitboards.h"
+#include "board.h"
+#include "pyrrhic/tbprobe.h"
+#include "time.h"
+#include "types.h"
+
+/*
+    Ethereal generates WDL bitbases for KPK, KRK and KQK at startup, which
+    allows these endings to be resolved without any Syzygy files. Positions
+    are indexed from the viewpoint of the strong side playing as White, by
+    side to move, both kings, and the square of the lone piece. A single
+    bit records whether the strong side wins; every other position draws.
+
+    The bitbases are built by a retrograde fixed point iteration. KRK and
+    KQK are generated in parallel, followed by KPK, which resolves its
+    promotions using the completed KRK and KQK bitbases
+
+    KRKP is generated lazily, the first time a probe needs it, since it is
+    48 times the size of the others. The Rook's side plays as White, and
+    the Pawn is mirrored onto the A to D files. Two bits per position hold
+    a win, draw, or loss for the Rook's side, or an unknown result. The
+    promotions lead into KRKQ and friends, which are not generated. So the
+    bitbase is built twice, once with every promotion assumed to win for
+    the Rook's side, and once with each promotion scored by what White can
+    recapture. Positions on which the two agree are known exactly
+*/
+
+enum { RESULT_INVALID, RESULT_UNKNOWN, RESULT_DRAW, RESULT_WIN, RESULT_LOSS };
+
+enum {
+    KRKP_UNKNOWN, KRKP_LOSS, KRKP_DRAW, KRKP_WIN,
+    KRKP_SIZE = BITBASE_SIZE * 24,
+};
+
+int BitbasesBlocking = 1; // Set for each search by getBestMove()
+
+static uint64_t Bitbases[BITBASE_NB][BITBASE_SIZE / 64];
+static atomic_int BitbasesReady;
+static pthread_t BitbasesThread;
+static double BitbasesTime;
+
+static uint64_t KRKPBitbase[KRKP_SIZE / 32];
+static atomic_int KRKPReady;
+static atomic_flag KRKPStarted = ATOMIC_FLAG_INIT;
+static pthread_once_t KRKPOnce = PTHREAD_ONCE_INIT;
+
+static int bitbaseIndex(int turn, int wking, int bking, int sq) {
+    return turn + 2 * (wking + SQUARE_NB * (bking + SQUARE_NB * sq));
+}
+
+static int bitbaseWins(int type, int index) {
+    return (Bitbases[type][index / 64] >> (index % 64)) & 1;
+}
+
+static uint64_t bitbasePieceAttacks(int type, int sq, uint64_t occupied) {
+    return type == BITBASE_KPK ? pawnAttacks(WHITE, sq)
+         : type == BITBASE_KRK ? rookAttacks(sq, occupied)
+                               : queenAttacks(sq, occupied);
+}
+
+static int classifyInitial(int type, int turn, int wking, int bking, int sq) {
+
+    const uint64_t occupied = (1ull << wking) | (1ull << bking) | (1ull << sq);
+
+    // Pieces must sit on distinct squares, and pawns may not be on the back ranks
+    if (popcount(occupied) != 3 || (type == BITBASE_KPK && ((1ull << sq) & PROMOTION_RANKS)))
+        return RESULT_INVALID;
+
+    // Kings may not touch, and the side not to move may not be in check
+    if (   testBit(kingAttacks(wking), bking)
+        || (turn == WHITE && testBit(bitbasePieceAttacks(type, sq, occupied), bking)))
+        return RESULT_INVALID;
+
+    return RESULT_UNKNOWN;
+}
+
+static int classifyWhite(int type, uint8_t *results, int wking, int bking, int sq) {
+
+    // The strong side wins if any move wins, and draws if every move draws
+
+    const uint64_t occupied = (1ull << wking) | (1ull << bking) | (1ull << sq);
+    uint64_t targets;
+    int unknown = 0, result;
+
+    // King moves, avoiding the enemy king and our own piece
+    targets = kingAttacks(wking) & ~kingAttacks(bking) & ~occupied;
+    while (targets) {
+        result = results[bitbaseIndex(BLACK, poplsb(&targets), bking, sq)];
+        if (result == RESULT_WIN) return RESULT_WIN;
+        unknown |= result == RESULT_UNKNOWN;
+    }
+
+    // Rook and Queen moves, which may not capture the enemy king
+    if (type != BITBASE_KPK) {
+        targets = bitbasePieceAttacks(type, sq, occupied) & ~occupied;
+        while (targets) {
+            result = results[bitbaseIndex(BLACK, wking, bking, poplsb(&targets))];
+            if (result == RESULT_WIN) return RESULT_WIN;
+            unknown |= result == RESULT_UNKNOWN;
+        }
+    }
+
+    // Pawn pushes, with promotions resolved by KRK and KQK. The
+    // promotions to a Bishop or a Knight would only ever draw
+    if (type == BITBASE_KPK && !testBit(occupied, sq + 8)) {
+
+        if (rankOf(sq) == 6) {
+            int index = bitbaseIndex(BLACK, wking, bking, sq + 8);
+            if (bitbaseWins(BITBASE_KQK, index) || bitbaseWins(BITBASE_KRK, index))
+                return RESULT_WIN;
+        }
+
+        else {
+
+            result = results[bitbaseIndex(BLACK, wking, bking, sq + 8)];
+            if (result == RESULT_WIN) return RESULT_WIN;
+            unknown |= result == RESULT_UNKNOWN;
+
+            if (rankOf(sq) == 1 && !testBit(occupied, sq + 16)) {
+                result = results[bitbaseIndex(BLACK, wking, bking, sq + 16)];
+                if (result == RESULT_WIN) return RESULT_WIN;
+                unknown |= result == RESULT_UNKNOWN;
+            }
+        }
+    }
+
+    return unknown ? RESULT_UNKNOWN : RESULT_DRAW;
+}
+
+static int classifyBlack(int type, uint8_t *results, int wking, int bking, int sq) {
+
+    // The lone king draws if any move draws, and loses if every move loses
+
+    const uint64_t occupied = (1ull << wking) | (1ull << bking) | (1ull << sq);
+    const uint64_t attacked = bitbasePieceAttacks(type, sq, occupied ^ (1ull << bking));
+    uint64_t targets = kingAttacks(bking) & ~kingAttacks(wking) & ~attacked;
+    int unknown = 0, result, to;
+
+    // Checkmate or stalemate
+    if (!targets)
+        return testBit(attacked, bking) ? RESULT_WIN : RESULT_DRAW;
+
+    while (targets) {
+
+        // Capturing the undefended piece leaves a bare king draw
+        if ((to = poplsb(&targets)) == sq)
+            return RESULT_DRAW;
+
+        result = results[bitbaseIndex(WHITE, wking, to, sq)];
+        if (result == RESULT_DRAW) return RESULT_DRAW;
+        unknown |= result == RESULT_UNKNOWN;
+    }
+
+    return unknown ? RESULT_UNKNOWN : RESULT_WIN;
+}
+
+static void generateBitbase(int type) {
+
+    uint8_t *results = malloc(BITBASE_SIZE);
+    int changed = 1;
+
+    for (int index = 0; index < BITBASE_SIZE; index++)
+        results[index] = classifyInitial(type, index % 2, (index / 2) % 64,
+                                         (index / 128) % 64, index / 8192);
+
+    // Iterate until no unknown position can be resolved any further
+    while (changed) {
+
+        changed = 0;
+
+        for (int index = 0; index < BITBASE_SIZE; index++) {
+
+            if (results[index] != RESULT_UNKNOWN)
+                continue;
+
+            int wking = (index / 2) % 64, bking = (index / 128) % 64, sq = index / 8192;
+
+            int result = index % 2 == WHITE
+                       ? classifyWhite(type, results, wking, bking, sq)
+                       : classifyBlack(type, results, wking, bking, sq);
+
+            if (result != RESULT_UNKNOWN)
+                results[index] = result, changed = 1;
+        }
+    }
+
+    // Any position still unresolved can never be forced to a win
+    for (int index = 0; index < BITBASE_SIZE; index++)
+        if (results[index] == RESULT_WIN)
+            Bitbases[type][index / 64] |= 1ull << (index % 64);
+
+    free(results);
+}
+
+static void *generateBitbaseThread(void *type) {
+    generateBitbase(*(int*) type);
+    return NULL;
+}
+
+static void *generateBitbases(void *unused) {
+
+    static int KRK = BITBASE_KRK, KQK = BITBASE_KQK;
+    double start = getRealTime();
+    pthread_t threads[2];
+
+    (void) unused;
+
+    pthread_create(&threads[0], NULL, &generateBitbaseThread, &KRK);
+    pthread_create(&threads[1], NULL, &generateBitbaseThread, &KQK);
+    pthread_join(threads[0], NULL);
+    pthread_join(threads[1], NULL);
+
+    generateBitbase(BITBASE_KPK);
+
+    BitbasesTime = getRealTime() - start;
+    atomic_store_explicit(&BitbasesReady, 1, memory_order_release);
+
+    return NULL;
+}
+
+static int krkpIndex(int turn, int wking, int bking, int rook, int pawn) {
+    return bitbaseIndex(turn, wking, bking, rook)
+         + BITBASE_SIZE * (4 * (rankOf(pawn) - 1) + fileOf(pawn));
+}
+
+static int krkpPawn(int index) {
+    return square(1 + (index / BITBASE_SIZE) / 4, (index / BITBASE_SIZE) % 4);
+}
+
+static int blackWins(int type, int wking, int bking, int sq) {
+
+    // Probe with Black as the strong side and White to move, by
+    // flipping the board so that the strong side plays as White
+
+    return bitbaseWins(type, bitbaseIndex(BLACK, relativeSquare(BLACK, bking),
+        relativeSquare(BLACK, wking), relativeSquare(BLACK, sq)));
+}
+
+static int krkResult(int wking, int bking, int rook) {
+    return bitbaseWins(BITBASE_KRK, bitbaseIndex(BLACK, wking, bking, rook)) ? RESULT_WIN : RESULT_DRAW;
+}
+
+static int promotionFloor(int wking, int bking, int rook, int sq) {
+
+    // The least White can expect after Black promotes on sq, which is
+    // whatever KRK is left after recapturing the new piece, if possible
+
+    const uint64_t occupied = (1ull << wking) | (1ull << bking) | (1ull << rook) | (1ull << sq);
+    int result = RESULT_LOSS;
+
+    if (testBit(rookAttacks(rook, occupied), sq))
+        result = krkResult(wking, bking, sq);
+
+    if (   result != RESULT_WIN
+        && testBit(kingAttacks(wking), sq)
+        && !testBit(kingAttacks(bking), sq))
+        result = krkResult(sq, bking, rook);
+
+    return result;
+}
+
+static int classifyInitialKRKP(int turn, int wking, int bking, int rook, int pawn) {
+
+    const uint64_t occupied = (1ull << wking) | (1ull << bking) | (1ull << rook) | (1ull << pawn);
+
+    // Pieces must sit on distinct squares, and the Kings may not touch
+    if (popcount(occupied) != 4 || testBit(kingAttacks(wking), bking))
+        return RESULT_INVALID;
+
+    // The side not to move may not be in check
+    if (turn == WHITE ? testBit(rookAttacks(rook, occupied), bking)
+                      : testBit(pawnAttacks(BLACK, pawn), wking))
+        return RESULT_INVALID;
+
+    return RESULT_UNKNOWN;
+}
+
+static int classifyWhiteKRKP(uint8_t *results, int wking, int bking, int rook, int pawn) {
+
+    // White wins if any move wins, loses if every move loses, and
+    // otherwise draws, once none of the moves remain unknown
+
+    const uint64_t occupied = (1ull << wking) | (1ull << bking) | (1ull << rook) | (1ull << pawn);
+    const uint64_t attacked = pawnAttacks(BLACK, pawn) | kingAttacks(bking);
+    const int inCheck = testBit(pawnAttacks(BLACK, pawn), wking);
+
+    uint64_t targets;
+    int unknown = 0, draw = 0, moves = 0, result, to;
+
+    // King moves, which may capture the Pawn when it is undefended
+    targets = kingAttacks(wking) & ~attacked & ~(1ull << rook);
+    while (targets) {
+        to = poplsb(&targets), moves++;
+        result = to == pawn ? krkResult(to, bking, rook)
+               : results[krkpIndex(BLACK, to, bking, rook, pawn)];
+        if (result == RESULT_WIN) return RESULT_WIN;
+        unknown |= result == RESULT_UNKNOWN, draw |= result == RESULT_DRAW;
+    }
+
+    // Rook moves, where only capturing the Pawn can answer a check
+    targets = rookAttacks(rook, occupied) & ~(1ull << wking) & (inCheck ? 1ull << pawn : ~0ull);
+    while (targets) {
+        to = poplsb(&targets), moves++;
+        result = to == pawn ? krkResult(wking, bking, to)
+               : results[krkpIndex(BLACK, wking, bking, to, pawn)];
+        if (result == RESULT_WIN) return RESULT_WIN;
+        unknown |= result == RESULT_UNKNOWN, draw |= result == RESULT_DRAW;
+    }
+
+    // Checkmate or stalemate
+    if (!moves)
+        return inCheck ? RESULT_LOSS : RESULT_DRAW;
+
+    return unknown ? RESULT_UNKNOWN : draw ? RESULT_DRAW : RESULT_LOSS;
+}
+
+static int classifyBlackKRKP(uint8_t *results, int optimistic, int wking, int bking, int rook, int pawn) {
+
+    // Black wins if any move wins, loses if every move loses, and
+    // otherwise draws, once none of the moves remain unknown
+
+    const uint64_t occupied = (1ull << wking) | (1ull << bking) | (1ull << rook) | (1ull << pawn);
+    const uint64_t attacked = rookAttacks(rook, occupied ^ (1ull << bking)) | kingAttacks(wking);
+    const int inCheck = testBit(rookAttacks(rook, occupied), bking);
+
+    uint64_t targets;
+    int unknown = 0, draw = 0, moves = 0, result, to;
+
+    // King moves, which may capture the Rook when it is undefended
+    targets = kingAttacks(bking) & ~attacked & ~(1ull << pawn);
+    while (targets) {
+        to = poplsb(&targets), moves++;
+        result = to == rook ? (blackWins(BITBASE_KPK, wking, to, pawn) ? RESULT_LOSS : RESULT_DRAW)
+               : results[krkpIndex(WHITE, wking, to, rook, pawn)];
+        if (result == RESULT_LOSS) return RESULT_LOSS;
+        unknown |= result == RESULT_UNKNOWN, draw |= result == RESULT_DRAW;
+    }
+
+    // Pawn captures of the Rook, which can no longer give check
+    if (testBit(pawnAttacks(BLACK, pawn), rook)) {
+
+        moves++;
+
+        if (rankOf(rook) == 0)
+            result = blackWins(BITBASE_KQK, wking, bking, rook) || blackWins(BITBASE_KRK, wking, bking, rook)
+                   ? RESULT_LOSS : RESULT_DRAW;
+        else
+            result = blackWins(BITBASE_KPK, wking, bking, rook) ? RESULT_LOSS : RESULT_DRAW;
+
+        if (result == RESULT_LOSS) return RESULT_LOSS;
+        draw |= result == RESULT_DRAW;
+    }
+
+    // Pawn pushes, which must not leave the King in check. Promotions
+    // either win for White, or give White only what it can recapture
+    for (to = pawn - 8; !testBit(occupied, to); to -= 8) {
+
+        if (!testBit(rookAttacks(rook, occupied ^ (1ull << pawn) ^ (1ull << to)), bking)) {
+
+            moves++;
+
+            result = rankOf(to) != 0 ? results[krkpIndex(WHITE, wking, bking, rook, to)]
+                   : optimistic      ? RESULT_WIN : promotionFloor(wking, bking, rook, to);
+
+            if (result == RESULT_LOSS) return RESULT_LOSS;
+            unknown |= result == RESULT_UNKNOWN, draw |= result == RESULT_DRAW;
+        }
+
+        // Only Pawns on their starting rank may advance twice
+        if (rankOf(pawn) != 6 || to != pawn - 8)
+            break;
+    }
+
+    // Checkmate or stalemate
+    if (!moves)
+        return inCheck ? RESULT_WIN : RESULT_DRAW;
+
+    return unknown ? RESULT_UNKNOWN : draw ? RESULT_DRAW : RESULT_WIN;
+}
+
+static uint8_t *generateKRKPResults(int optimistic) {
+
+    uint8_t *results = malloc(KRKP_SIZE);
+    int changed = 1;
+
+    for (int index = 0; index < KRKP_SIZE; index++)
+        results[index] = classifyInitialKRKP(index % 2, (index / 2) % 64,
+            (index / 128) % 64, (index / 8192) % 64, krkpPawn(index));
+
+    // Iterate until no unknown position can be resolved any further
+    while (changed) {
+
+        changed = 0;
+
+        for (int index = 0; index < KRKP_SIZE; index++) {
+
+            if (results[index] != RESULT_UNKNOWN)
+                continue;
+
+            int wking = (index / 2) % 64, bking = (index / 128) % 64;
+            int rook  = (index / 8192) % 64, pawn = krkpPawn(index);
+
+            int result = index % 2 == WHITE
+                       ? classifyWhiteKRKP(results, wking, bking, rook, pawn)
+                       : classifyBlackKRKP(results, optimistic, wking, bking, rook, pawn);
+
+            if (result != RESULT_UNKNOWN)
+                results[index] = result, changed = 1;
+        }
+    }
+
+    // Neither side can force a result from the remaining positions
+    for (int index = 0; index < KRKP_SIZE; index++)
+        if (results[index] == RESULT_UNKNOWN)
+            results[index] = RESULT_DRAW;
+
+    return results;
+}
+
+static void *generateKRKPResultsThread(void *optimistic) {
+    return generateKRKPResults(*(int*) optimistic);
+}
+
+static void generateKRKP() {
+
+    static int Pessimistic = 0, Optimistic = 1;
+    uint8_t *pessimistic, *optimistic;
+    pthread_t threads[2];
+
+    pthread_create(&threads[0], NULL, &generateKRKPResultsThread, &Pessimistic);
+    pthread_create(&threads[1], NULL, &generateKRKPResultsThread, &Optimistic);
+    pthread_join(threads[0], (void **) &pessimistic);
+    pthread_join(threads[1], (void **) &optimistic);
+
+    for (int index = 0; index < KRKP_SIZE; index++) {
+
+        if (pessimistic[index] != optimistic[index])
+            continue;
+
+        uint64_t value = optimistic[index] == RESULT_WIN  ? KRKP_WIN
+                       : optimistic[index] == RESULT_DRAW ? KRKP_DRAW
+                       : optimistic[index] == RESULT_LOSS ? KRKP_LOSS : KRKP_UNKNOWN;
+
+        KRKPBitbase[index / 32] |= value << (2 * (index % 32));
+    }
+
+    free(pessimistic);
+    free(optimistic);
+
+    atomic_store_explicit(&KRKPReady, 1, memory_order_release);
+}
+
+static void *generateKRKPThread(void *unused) {
+    (void) unused;
+    pthread_once(&KRKPOnce, &generateKRKP);
+    return NULL;
+}
+
+static int probeKRKP(Board *board, int strong) {
+
+    const uint64_t kings = board->pieces[KING];
+    pthread_t thread;
+
+    // Generate KRKP on first use, blocking only when a search asked
+    // for reproducible results. Otherwise probes miss until it is done
+    if (!atomic_load_explicit(&KRKPReady, memory_order_acquire)) {
+
+        if (BitbasesBlocking)
+            pthread_once(&KRKPOnce, &generateKRKP);
+
+        else {
+            if (!atomic_flag_test_and_set(&KRKPStarted)) {
+                pthread_create(&thread, NULL, &generateKRKPThread, NULL);
+                pthread_detach(thread);
+            }
+            return BITBASE_UNKNOWN;
+        }
+    }
+
+    // Flip the board vertically when the Rook is Black's, and
+    // then horizontally to bring the Pawn onto the A to D files
+    int wking = relativeSquare(strong, getlsb(kings & board->colours[ strong]));
+    int bking = relativeSquare(strong, getlsb(kings & board->colours[!strong]));
+    int rook  = relativeSquare(strong, getlsb(board->pieces[ROOK]));
+    int pawn  = relativeSquare(strong, getlsb(board->pieces[PAWN]));
+    int turn  = board->turn == strong ? WHITE : BLACK;
+
+    if (fileOf(pawn) >= 4)
+        wking ^= 7, bking ^= 7, rook ^= 7, pawn ^= 7;
+
+    int index = krkpIndex(turn, wking, bking, rook, pawn);
+    int value = (KRKPBitbase[index / 32] >> (2 * (index % 32))) & 3;
+
+    if (value == KRKP_UNKNOWN) return BITBASE_UNKNOWN;
+    if (value == KRKP_DRAW   ) return BITBASE_DRAW;
+
+    return (value == KRKP_WIN) == (turn == WHITE) ? BITBASE_WIN : BITBASE_LOSS;
+}
+
+void initBitbases() {
+
+    // Build the Bitbases in the background, while the interface
+    // sets things up. Probes fail until the generation completes
+    pthread_create(&BitbasesThread, NULL, &generateBitbases, NULL);
+}
+
+void waitForBitbases() {
+
+    static int joined;
+
+    // Block until the Bitbases are ready, so that searches are
+    // reproducible, and report the cost of generating them once
+    if (!joined) {
+        pthread_join(BitbasesThread, NULL), joined = 1;
+        printf("info string Bitbases KPK, KRK, KQK generated in %dms using %dKB\n",
+            (int) BitbasesTime, (int) (sizeof(Bitbases) / 1024));
+        fflush(stdout);
+    }
+}
+
+int bitbasesProbe(Board *board) {
+
+    const uint64_t white = board->colours[WHITE];
+    const uint64_t black = board->colours[BLACK];
+    const uint64_t kings = board->pieces[KING];
+
+    int type, strong, wking, bking, sq, turn, index;
+
+    if (!atomic_load_explicit(&BitbasesReady, memory_order_acquire))
+        return BITBASE_UNKNOWN;
+
+    // KRKP, with the Rook and the Pawn on opposite sides
+    if (   popcount(white | black) == 4
+        && popcount(board->pieces[ROOK]) == 1 && popcount(board->pieces[PAWN]) == 1
+        && testBit(white, getlsb(board->pieces[ROOK])) != testBit(white, getlsb(board->pieces[PAWN])))
+        return probeKRKP(board, testBit(black, getlsb(board->pieces[ROOK])));
+
+    if (popcount(white | black) != 3)
+        return BITBASE_UNKNOWN;
+
+    // Identify the lone piece, which must be a Pawn, Rook or Queen
+    sq   = getlsb((white | black) & ~kings);
+    type = testBit(board->pieces[PAWN], sq) ? BITBASE_KPK
+         : testBit(board->pieces[ROOK], sq) ? BITBASE_KRK
+         : testBit(board->pieces[QUEEN], sq) ? BITBASE_KQK : -1;
+
+    if (type == -1)
+        return BITBASE_UNKNOWN;
+
+    // Flip the board vertically when the strong side is Black
+    strong = testBit(black, sq);
+    wking  = relativeSquare(strong, getlsb(kings & board->colours[ strong]));
+    bking  = relativeSquare(strong, getlsb(kings & board->colours[!strong]));
+    turn   = board->turn == strong ? WHITE : BLACK;
+    index  = bitbaseIndex(turn, wking, bking, relativeSquare(strong, sq));
+
+    if (!bitbaseWins(type, index))
+        return BITBASE_DRAW;
+
+    return turn == WHITE ? BITBASE_WIN : BITBASE_LOSS;
+}
+
+unsigned bitbasesProbeWDL(Board *board, int height) {
+
+    // Follow the same conditions as for Syzygy. Never probe at the Root, and
+    // only probe when the fifty move rule counter has just been reset
+
+    if (height == 0 || board->halfMoveCounter)
+        return TB_RESULT_FAILED;
+
+    switch (bitbasesProbe(board)) {
+        case BITBASE_WIN  : return TB_WIN;
+        case BITBASE_DRAW : return TB_DRAW;
+        case BITBASE_LOSS : return TB_LOSS;
+        default           : return TB_RESULT_FAILED;
+    }
+}
@@ -0,0 +1,41 @@
+/*
+  Ethereal is a UCI chess playing engine authored by Andrew Grant.
+  <https://github.com/AndyGrant/Ethereal>     <andrew@grantnet.us>
+
+  Ethereal is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Ethereal is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <stdint.h>
+
+#include "types.h"
+
+enum {
+    BITBASE_KPK, BITBASE_KRK, BITBASE_KQK, BITBASE_NB,
+    BITBASE_SIZE = 2 * SQUARE_NB * SQUARE_NB * SQUARE_NB,
+};
+
+enum {
+    BITBASE_UNKNOWN = -1,
+    BITBASE_LOSS, BITBASE_DRAW, BITBASE_WIN,
+};
+
+extern int BitbasesBlocking;
+
+void initBitbases();
+void waitForBitbases();
+int bitbasesProbe(Board *board);
+unsigned bitbasesProbeWDL(Board *board, int height);
@@ -22,6 +22,7 @@
 #include <stdio.h>
 
 #include "bitboards.h"
+#include "cpu.h"
 #include "types.h"
 
 const uint64_t Files[FILE_NB] = {FILE_A, FILE_B, FILE_C, FILE_D, FILE_E, FILE_F, FILE_G, FILE_H};
@@ -83,6 +84,17 @@ int backmost(int colour, uint64_t bb) {
 }
 
 int popcount(uint64_t bb) {
+
+#if defined(USE_DISPATCH)
+    // The instruction is emitted directly, since builds which dispatch
+    // at runtime may not assume POPCNT when generating code
+    if (CPUPopcnt) {
+        uint64_t count;
+        asm ("popcntq %1, %0" : "=r" (count) : "rm" (bb));
+        return count;
+    }
+#endif
+
     return __builtin_popcountll(bb);
 }
 
@@ -28,8 +28,9 @@
 #include "board.h"
 #include "evaluate.h"
 #include "masks.h"
+#include "material.h"
 #include "move.h"
-#include "movegen.h"
+#include "network.h"
 #include "search.h"
 #include "thread.h"
 #include "time.h"
@@ -48,6 +49,7 @@ static void clearBoard(Board *board) {
 
     memset(board, 0, sizeof(Board));
     memset(&board->squares, EMPTY, sizeof(board->squares));
+    resetPKAccumulator(board->pkaccum);
 }
 
 static void setSquare(Board *board, int colour, int piece, int sq) {
@@ -66,11 +68,14 @@ static void setSquare(Board *board, int colour, int piece, int sq) {
 
     board->psqtmat += PSQT[board->squares[sq]][sq];
     board->hash ^= ZobristKeys[board->squares[sq]][sq];
-    if (piece == PAWN || piece == KING)
+    board->matkey += MaterialKeys[board->squares[sq]][sq];
+    if (piece == PAWN || piece == KING) {
         board->pkhash ^= ZobristKeys[board->squares[sq]][sq];
+        addPKAccumulator(board->pkaccum, board->squares[sq], sq);
+    }
 }
 
-static int stringToSquare(char *str) {
+int stringToSquare(char *str) {
 
     // Helper for reading the enpass square from a FEN. If no square
     // is provided, Ethereal will use -1 to represent this internally
@@ -105,7 +110,7 @@ void boardFromFEN(Board *board, const char *fen, int chess960) {
     char ch;
     char *str = strdup(fen), *strPos = NULL;
     char *token = strtok_r(str, " ", &strPos);
-    uint64_t rooks, kings, white, black;
+    uint64_t rooks, white, black;
 
     clearBoard(board); // Zero out, set squares to EMPTY
 
@@ -133,7 +138,6 @@ void boardFromFEN(Board *board, const char *fen, int chess960) {
     token = strtok_r(NULL, " ", &strPos);
 
     rooks = board->pieces[ROOK];
-    kings = board->pieces[KING];
     white = board->colours[WHITE];
     black = board->colours[BLACK];
 
@@ -146,13 +150,6 @@ void boardFromFEN(Board *board, const char *fen, int chess960) {
         if ('a' <= ch && ch <= 'h') setBit(&board->castleRooks, square(7, ch - 'a'));
     }
 
-    for (sq = 0; sq < SQUARE_NB; sq++) {
-        board->castleMasks[sq] = ~0ull;
-        if (testBit(board->castleRooks, sq)) clearBit(&board->castleMasks[sq], sq);
-        if (testBit(white & kings, sq)) board->castleMasks[sq] &= ~white;
-        if (testBit(black & kings, sq)) board->castleMasks[sq] &= ~black;
-    }
-
     rooks = board->castleRooks;
     while (rooks) board->hash ^= ZobristCastleKeys[poplsb(&rooks)];
 
@@ -168,8 +165,14 @@ void boardFromFEN(Board *board, const char *fen, int chess960) {
     // Move count: ignore and use zero, as we count since root
     board->numMoves = 0;
 
+    // Build the Attack Map before it is used for check detection
+#ifdef USE_ATTACK_MAPS
+    refreshAttackMap(board);
+#endif
+
     // Need king attackers for move generation
     board->kingAttackers = attackersToKingSquare(board);
+    board->pinned = PINNED_UNKNOWN;
 
     // We save the game mode in order to comply with the UCI rules for printing
     // moves. If chess960 is not enabled, but we have detected an unconventional
@@ -319,35 +322,50 @@ int boardDrawnByRepetition(Board *board, int height) {
     return 0;
 }
 
-int boardDrawnByInsufficientMaterial(Board *board) {
+int boardHasUpcomingRepetition(Board *board, int height) {
 
-    // Check for KvK, KvN, KvB, and KvNN.
+    const uint64_t occupied = board->colours[WHITE] | board->colours[BLACK];
+    const int end = MIN(board->halfMoveCounter, board->numMoves);
 
-    return !(board->pieces[PAWN] | board->pieces[ROOK] | board->pieces[QUEEN])
-        && (!several(board->colours[WHITE]) || !several(board->colours[BLACK]))
-        && (    !several(board->pieces[KNIGHT] | board->pieces[BISHOP])
-            || (!board->pieces[BISHOP] && popcount(board->pieces[KNIGHT]) <= 2));
-}
+    // Look for a single reversible move which would return us to a position
+    // from the history. The two keys differ by exactly such a move, which the
+    // Cuckoo tables find in constant time, instead of playing any moves out
+    for (int i = 3; i <= end; i += 2) {
 
-uint64_t perft(Board *board, int depth) {
+        const uint64_t previous = board->history[board->numMoves - i];
+        const uint64_t moveKey  = board->hash ^ previous;
 
-    Undo undo[1];
-    int size = 0;
-    uint64_t found = 0ull;
-    uint16_t moves[MAX_MOVES];
+        int index = cuckooH1(moveKey);
+        if (CuckooKeys[index] != moveKey && CuckooKeys[index = cuckooH2(moveKey)] != moveKey)
+            continue;
 
-    if (depth == 0) return 1ull;
+        const int from = MoveFrom(CuckooMoves[index]);
+        const int to   = MoveTo(CuckooMoves[index]);
 
-    // Call genAllNoisyMoves() & genAllNoisyMoves()
-    size += genAllNoisyMoves(board, moves);
-    size += genAllQuietMoves(board, moves + size);
+        // The move must not be blocked by any other pieces
+        if (bitsBetweenMasks(from, to) & occupied)
+            continue;
+
+        // A repetition after the root needs to occur only once
+        if (i < height)
+            return 1;
 
-    // Recurse on all valid moves
-    for(size -= 1; size >= 0; size--) {
-        applyMove(board, moves[size], undo);
-        if (moveWasLegal(board)) found += perft(board, depth-1);
-        revertMove(board, moves[size], undo);
+        // Before the root, the move must be ours to make, and the position
+        // must already have occurred twice, matching boardDrawnByRepetition()
+        const int piece = board->squares[board->squares[from] == EMPTY ? to : from];
+        if (pieceColour(piece) != board->turn)
+            continue;
+
+        for (int j = board->numMoves - i - 4; j >= board->numMoves - end; j -= 2)
+            if (board->history[j] == previous) return 1;
     }
 
-    return found;
+    return 0;
+}
+
+int boardDrawnByInsufficientMaterial(Board *board) {
+
+    // Check for KvK, KvN, KvB, and KvNN.
+
+    return materialIsDrawn(board->matkey);
 }
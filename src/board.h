@@ -18,25 +18,48 @@
 
 #pragma once
 
+#include <stddef.h>
+
+#include "attackmap.h"
+#include "network.h"
 #include "types.h"
 
 extern const char *PieceLabel[COLOUR_NB];
 
+// Every square can never be pinned, so this marks board->pinned as not yet computed
+#define PINNED_UNKNOWN (~0ull)
+
 struct Board {
     uint8_t squares[SQUARE_NB];
     uint64_t pieces[8], colours[3];
-    uint64_t hash, pkhash, kingAttackers;
-    uint64_t castleRooks, castleMasks[SQUARE_NB];
+    uint64_t hash, pkhash, matkey, kingAttackers, pinned;
+    uint64_t castleRooks;
     int turn, epSquare, halfMoveCounter, fullMoveCounter;
     int psqtmat, numMoves, chess960;
-    uint64_t history[512];
+    NNUEAccumulator *nnue;
+    int16_t pkaccum[PKNETWORK_LAYER1];
+#ifdef USE_ATTACK_MAPS
+    AttackMap attackmap;
+#endif
+    uint64_t history[512]; // Cold, only read when checking for repetitions
 };
 
+// Everything ahead of the history, which is all that copy-make has to save
+#define BOARD_HOT_SIZE (offsetof(Board, history))
+
+// Optional copy-make saves the hot part of the Board whole, in place of
+// restoring it field by field in revertMove(). See COPYMAKE in the makefile
+
 struct Undo {
-    uint64_t hash, pkhash, kingAttackers, castleRooks;
+    uint64_t hash, pkhash, matkey, kingAttackers, pinned, castleRooks;
     int epSquare, halfMoveCounter, psqtmat, capturePiece;
+    int16_t pkaccum[PKNETWORK_LAYER1];
+#ifdef USE_COPY_MAKE
+    uint8_t board[BOARD_HOT_SIZE];
+#endif
 };
 
+int stringToSquare(char *str);
 void squareToString(int sq, char *str);
 void boardFromFEN(Board *board, const char *fen, int chess960);
 void boardToFEN(Board *board, char *fen);
@@ -45,6 +68,6 @@ int boardHasNonPawnMaterial(Board *board, int turn);
 int boardIsDrawn(Board *board, int height);
 int boardDrawnByFiftyMoveRule(Board *board);
 int boardDrawnByRepetition(Board *board, int height);
+int boardHasUpcomingRepetition(Board *board, int height);
 int boardDrawnByInsufficientMaterial(Board *board);
 
-uint64_t perft(Board *board, int depth);
@@ -0,0 +1,221 @@
+/*
+  Ethereal is a UCI chess playing engine authored by Andrew Grant.
+  <https://github.com/AndyGrant/Ethereal>     <andrew@grantnet.us>
+
+  Ethereal is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Ethereal is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32) || defined(_WIN64)
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#include "bitboards.h"
+#include "board.h"
+#include "book.h"
+#include "move.h"
+#include "movegen.h"
+#include "time.h"
+#include "types.h"
+#include "zobrist.h"
+
+int OwnBook;      // Set by UCI options
+int BookBestMove; // Set by UCI options
+
+static const uint8_t *BookData; // Raw big-endian Polyglot entries
+static uint64_t BookEntries;    // Number of 16-byte entries
+static uint64_t BookSeed;       // State for weighted selection
+
+static uint64_t readBigEndian(const uint8_t *data, int bytes) {
+
+    uint64_t value = 0ull;
+
+    for (int i = 0; i < bytes; i++)
+        value = (value << 8) | data[i];
+
+    return value;
+}
+
+static void readBookEntry(uint64_t index, PolyglotEntry *entry) {
+
+    const uint8_t *data = BookData + 16 * index;
+
+    entry->key    = readBigEndian(data +  0, 8);
+    entry->move   = readBigEndian(data +  8, 2);
+    entry->weight = readBigEndian(data + 10, 2);
+    entry->learn  = readBigEndian(data + 12, 4);
+}
+
+static void closeBook() {
+
+    if (BookData == NULL)
+        return;
+
+#if defined(_WIN32) || defined(_WIN64)
+    free((void*) BookData);
+#else
+    munmap((void*) BookData, 16 * BookEntries);
+#endif
+
+    BookData = NULL, BookEntries = 0ull;
+}
+
+int initBook(const char *path) {
+
+    // Polyglot books are sorted by key, so the file may be mapped and
+    // searched directly. We fall back to reading the file into memory
+    // when mmap() is not available. An empty path only closes the book
+
+    closeBook();
+
+    if (path == NULL)
+        return 1;
+
+#if defined(_WIN32) || defined(_WIN64)
+
+    FILE *fin = fopen(path, "rb");
+    if (fin == NULL) return 0;
+
+    fseek(fin, 0, SEEK_END);
+    long size = ftell(fin);
+    fseek(fin, 0, SEEK_SET);
+
+    if (size >= 16 && size % 16 == 0) {
+        BookEntries = size / 16;
+        BookData = malloc(16 * BookEntries);
+        if (fread((void*) BookData, 16, BookEntries, fin) != BookEntries)
+            free((void*) BookData), BookData = NULL, BookEntries = 0ull;
+    }
+
+    fclose(fin);
+
+#else
+
+    struct stat st;
+    int fd = open(path, O_RDONLY);
+    if (fd == -1) return 0;
+
+    if (fstat(fd, &st) == 0 && st.st_size >= 16 && st.st_size % 16 == 0) {
+        BookEntries = st.st_size / 16;
+        BookData = mmap(NULL, 16 * BookEntries, PROT_READ, MAP_SHARED, fd, 0);
+        if (BookData == MAP_FAILED) BookData = NULL, BookEntries = 0ull;
+    }
+
+    close(fd);
+
+#endif
+
+    // Scramble the clock, since close seeds give close first outputs
+    BookSeed = ((uint64_t) getRealTime() * 0x9E3779B97F4A7C15ull) | 1ull;
+
+    return BookData != NULL;
+}
+
+static uint16_t bookMoveToMove(Board *board, uint16_t bookMove) {
+
+    // Polyglot packs the move as to-file, to-row, from-file, from-row,
+    // and promotion piece, in three bit chunks. Castles are encoded as
+    // the king capturing its own rook, just as Ethereal encodes them
+
+    uint16_t moves[MAX_MOVES];
+    int size = genAllLegalMoves(board, moves);
+
+    int to    = square((bookMove >> 3) & 7, (bookMove >> 0) & 7);
+    int from  = square((bookMove >> 9) & 7, (bookMove >> 6) & 7);
+    int promo = (bookMove >> 12) & 7;
+
+    for (int i = 0; i < size; i++)
+        if (   MoveFrom(moves[i]) == from && MoveTo(moves[i]) == to
+            && (MoveType(moves[i]) == PROMOTION_MOVE ? MovePromoPiece(moves[i]) : 0) == promo)
+            return moves[i];
+
+    return NONE_MOVE;
+}
+
+static uint16_t selectBookMove(Board *board) {
+
+    PolyglotEntry entry;
+    uint64_t key = polyglotKey(board);
+    uint64_t lower = 0ull, upper = BookEntries, first;
+    uint32_t total = 0, pick;
+    uint16_t move = NONE_MOVE, best = 0;
+
+    // Binary search for the first entry matching the key
+    while (lower < upper) {
+        uint64_t middle = lower + (upper - lower) / 2;
+        readBookEntry(middle, &entry);
+        if (entry.key < key) lower = middle + 1;
+        else upper = middle;
+    }
+
+    // Sum the weights of every entry for the position
+    for (first = lower; lower < BookEntries; lower++) {
+        readBookEntry(lower, &entry);
+        if (entry.key != key) break;
+        total += entry.weight;
+    }
+
+    if (first == lower)
+        return NONE_MOVE;
+
+    // Select either the heaviest move, or a move with a probability
+    // proportional to its weight. Zero weights are never selected
+    BookSeed ^= BookSeed >> 12, BookSeed ^= BookSeed << 25, BookSeed ^= BookSeed >> 27;
+    pick = total ? (BookSeed * 2685821657736338717ull) % total : 0;
+
+    for (uint64_t i = first; i < lower; i++) {
+
+        readBookEntry(i, &entry);
+
+        if (BookBestMove && entry.weight > best)
+            move = entry.move, best = entry.weight;
+
+        if (!BookBestMove && entry.weight > pick) {
+            move = entry.move;
+            break;
+        }
+
+        pick -= entry.weight;
+    }
+
+    return move == NONE_MOVE ? NONE_MOVE : bookMoveToMove(board, move);
+}
+
+int probeBook(Board *board, uint16_t *best, uint16_t *ponder) {
+
+    Undo undo[1];
+
+    if (!OwnBook || BookData == NULL)
+        return 0;
+
+    if ((*best = selectBookMove(board)) == NONE_MOVE)
+        return 0;
+
+    // Use the book again to find a move to ponder on
+    applyMove(board, *best, undo);
+    *ponder = selectBookMove(board);
+    revertMove(board, *best, undo);
+
+    return 1;
+}
@@ -16,38 +16,114 @@
   along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <inttypes.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+#include "attacks.h"
+#include "bitbase.h"
+#include "bitboards.h"
 #include "board.h"
 #include "cmdline.h"
+#include "cpu.h"
+#include "evaluate.h"
 #include "move.h"
+#include "movegen.h"
+#include "movepicker.h"
+#include "nneval.h"
+#include "nnue.h"
+#include "perft.h"
 #include "search.h"
+#include "tablegen.h"
 #include "thread.h"
 #include "time.h"
 #include "transposition.h"
 #include "tuner.h"
 #include "uci.h"
+#include "weights.h"
+#include "zobrist.h"
+
+static const char *Benchmarks[] = {
+    #include "bench.csv"
+    ""
+};
 
 void handleCommandLine(int argc, char **argv) {
 
     // Benchmarker is being run from the command line
-    // USAGE: ./Ethereal bench <depth> <threads> <hash>
+    // USAGE: ./Ethereal bench <depth> <threads> <hash> <nodes> <evalfile|none> <paramsfile>
     if (argc > 1 && strEquals(argv[1], "bench")) {
         runBenchmark(argc, argv);
         exit(EXIT_SUCCESS);
     }
 
     // Bench is being run from the command line
-    // USAGE: ./Ethereal evalbook <book> <depth> <threads> <hash>
+    // USAGE: ./Ethereal evalbook <book> <depth> <threads> <hash> <nodes>
     if (argc > 2 && strEquals(argv[1], "evalbook")) {
         runEvalBook(argc, argv);
         exit(EXIT_SUCCESS);
     }
 
+    // Mate search suite is being run from the command line
+    // USAGE: ./Ethereal matebench <hash>
+    if (argc > 1 && strEquals(argv[1], "matebench")) {
+        runMateBenchmark(argc, argv);
+        exit(EXIT_SUCCESS);
+    }
+
+    // UCI position parsing latency is being measured
+    // USAGE: ./Ethereal positionbench <plies>
+    if (argc > 1 && strEquals(argv[1], "positionbench")) {
+        runPositionBenchmark(argc, argv);
+        exit(EXIT_SUCCESS);
+    }
+
+    // Evaluation speed of the HCE and the NNUE is being measured
+    // USAGE: ./Ethereal evalbench <evalfile|none> <depth>
+    if (argc > 1 && strEquals(argv[1], "evalbench")) {
+        runEvalBenchmark(argc, argv);
+        exit(EXIT_SUCCESS);
+    }
+
+    // Cost of each Endgame Network is being measured
+    // USAGE: ./Ethereal egbench <positions>
+    if (argc > 1 && strEquals(argv[1], "egbench")) {
+        runEndgameBenchmark(argc, argv);
+        exit(EXIT_SUCCESS);
+    }
+
+    // Startup cost of loading the PK and EG networks is being measured
+    // USAGE: ./Ethereal weightsbench <weightsfile>
+    if (argc > 1 && strEquals(argv[1], "weightsbench")) {
+        runWeightsBenchmark(argc, argv);
+        exit(EXIT_SUCCESS);
+    }
+
+    // Move generation is being validated against an EPD of perft results
+    // USAGE: ./Ethereal perftsuite <epd> <depth> <threads> <hash>
+    if (argc > 2 && strEquals(argv[1], "perftsuite")) {
+        runPerftSuite(argc, argv);
+        exit(EXIT_SUCCESS);
+    }
+
+    // Isolated kernels are being timed over the Benchmark positions
+    // USAGE: ./Ethereal microbench <milliseconds>
+    if (argc > 1 && strEquals(argv[1], "microbench")) {
+        runMicroBenchmark(argc, argv);
+        exit(EXIT_SUCCESS);
+    }
+
+    // Lookup tables are being written out as C source, see "make precomputed"
+    // USAGE: ./Ethereal tablegen <directory>
+    if (argc > 1 && strEquals(argv[1], "tablegen")) {
+        runTableGenerator(argc, argv);
+        exit(EXIT_SUCCESS);
+    }
+
     // Tuner is being run from the command line
     #ifdef TUNE
+        waitForBitbases();
         runTuner();
         exit(EXIT_SUCCESS);
     #endif
@@ -55,11 +131,6 @@ void handleCommandLine(int argc, char **argv) {
 
 void runBenchmark(int argc, char **argv) {
 
-    static const char *Benchmarks[] = {
-        #include "bench.csv"
-        ""
-    };
-
     Board board;
     Thread *threads;
     Limits limits = {0};
@@ -76,15 +147,26 @@ void runBenchmark(int argc, char **argv) {
     int depth     = argc > 2 ? atoi(argv[2]) : 13;
     int nthreads  = argc > 3 ? atoi(argv[3]) :  1;
     int megabytes = argc > 4 ? atoi(argv[4]) : 16;
+    uint64_t nlimit = argc > 5 ? strtoull(argv[5], NULL, 10) : 0ull;
+
+    // Search with the NNUE when given one, instead of the HCE
+    if (argc > 6 && !strEquals(argv[6], "none") && !(UseNNUE = initNNUE(argv[6])))
+        printf("Unable to load %s, using the HCE\n", argv[6]);
+
+    // Search with HCE terms printed by the Tuner, instead of the built in ones
+    if (argc > 7 && !loadEvalParams(argv[7]))
+        printf("Unable to load %s, using the built in terms\n", argv[7]);
 
     initTT(megabytes);
     time = getRealTime();
     threads = createThreadPool(nthreads);
 
-    // Initialize a "go depth <x>" search
+    // Initialize a "go depth <x> [nodes <y>]" search
     limits.multiPV        = 1;
     limits.limitedByDepth = 1;
     limits.depthLimit     = depth;
+    limits.limitedByNodes = nlimit != 0;
+    limits.nodeLimit      = nlimit;
 
     for (int i = 0; strcmp(Benchmarks[i], ""); i++) {
 
@@ -94,7 +176,7 @@ void runBenchmark(int argc, char **argv) {
         getBestMove(threads, &board, &limits, &bestMoves[i], &ponderMoves[i]);
 
         // Stat collection for later printing
-        scores[i] = threads->info->values[depth];
+        scores[i] = threads->info->values[threads->info->depth];
         times[i] = getRealTime() - limits.start;
         nodes[i] = nodesSearchedThreadPool(threads);
 
@@ -122,7 +204,664 @@ void runBenchmark(int argc, char **argv) {
     for (int i = 0; strcmp(Benchmarks[i], ""); i++) totalNodes += nodes[i];
     printf("OVERALL: %53d nodes %8d nps\n", (int)totalNodes, (int)(1000.0f * totalNodes / (time + 1)));
 
-    free(threads);
+    deleteThreadPool(threads);
+}
+
+void runMateBenchmark(int argc, char **argv) {
+
+    static const struct { const char *fen; int mate; } Mates[] = {
+        { "6k1/5ppp/8/8/8/8/5PPP/3R2K1 w - - 0 1", 1 },
+        { "kbK5/pp6/1P6/8/8/8/8/R7 w - - 0 1", 2 },
+        { "r2qkb1r/pp2nppp/3p4/2pNN1B1/2BnP3/3P4/PPP2PPP/R2bK2R w KQkq - 1 1", 2 },
+        { "r1b2k1r/ppp1bppp/8/1B1Q4/5q2/2P5/PPP2PPP/R3R1K1 w - - 1 1", 2 },
+        { "5rk1/1p1q2bp/p2pN1p1/2pP2Bn/2P3P1/1P6/P4QKP/5R2 w - - 1 1", 2 },
+        { "r1bq2r1/b4pk1/p1pp1p2/1p2pP2/1P2P1PB/3P4/1PPQ2P1/R3K2R w - - 0 1", 2 },
+        { "r1b1kb1r/pppp1ppp/5q2/4n3/3KP3/2N3PN/PPP4P/R1BQ1B1R b kq - 0 1", 3 },
+        { "r5rk/5p1p/5R2/4B3/8/8/7P/7K w - - 1 1", 3 },
+        { "2r3k1/p4p2/3Rp2p/1p2P1pK/8/1P4P1/P3Q2P/1q6 b - - 0 1", 3 },
+        { "r3k2r/ppp2Npp/1b5n/4p2b/2B1P2q/BQP2P2/P5PP/RN5K w kq - 1 1", 3 },
+        { "3r1r1k/1p3p1p/p2p4/4n1NN/6bQ/1BPq4/P3p1PP/1R5K w - - 0 1", 3 },
+        { "r1bqr3/ppp1B1kp/1b4p1/n2B4/3PQ1P1/2P5/P4P2/RN4K1 w - - 1 1", 4 },
+        { "8/8/8/4k3/8/8/8/3QK3 w - - 0 1", 7 },
+        { NULL, 0 }
+    };
+
+    Board board;
+    Thread *threads;
+    Limits limits = {0};
+    uint16_t best, ponder;
+
+    int solved = 0;
+    double time, total = 0.0;
+    uint64_t nodes, totalNodes = 0ull;
+
+    int megabytes = argc > 2 ? atoi(argv[2]) : 16;
+
+    initTT(megabytes);
+    threads = createThreadPool(1);
+
+    // Initialize a "go mate <x>" search, which falls back to depth 2x
+    limits.multiPV        = 1;
+    limits.limitedByMate  = 1;
+    limits.limitedByDepth = 1;
+
+    printf("\n=================================================================================\n");
+
+    for (int i = 0; Mates[i].fen != NULL; i++) {
+
+        char bestStr[6];
+
+        limits.mateLimit  = Mates[i].mate;
+        limits.depthLimit = 2 * Mates[i].mate;
+
+        // Time the search up until the final best move is known
+        limits.start = getRealTime();
+        boardFromFEN(&board, Mates[i].fen, 0);
+        getBestMove(threads, &board, &limits, &best, &ponder);
+        time  = getRealTime() - limits.start;
+        nodes = nodesSearchedThreadPool(threads);
+
+        // Solved when either search finds a mate in no more than N
+        int value = threads->info->values[threads->info->depth];
+        int found = value >= MATE_IN_MAX && MATE - value <= 2 * Mates[i].mate - 1;
+        solved += found, total += time, totalNodes += nodes;
+
+        moveToString(best, bestStr, 0);
+        printf("Mate [# %2d] M%-3d %6s  Best:%6s %12d nodes %8d ms\n", i + 1, Mates[i].mate,
+            found ? "Solved" : "Failed", bestStr, (int)nodes, (int)time);
+
+        resetThreadPool(threads); clearTT();
+    }
+
+    printf("=================================================================================\n");
+    printf("SOLVED: %d %43d nodes %8d ms\n", solved, (int)totalNodes, (int)total);
+
+    deleteThreadPool(threads);
+}
+
+void runPositionBenchmark(int argc, char **argv) {
+
+    static const char *StartFEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+    static char game[8192], command[8192];
+
+    Board board, uciBoard;
+    Undo undo[1];
+    uint16_t moves[MAX_MOVES];
+    int ends[1024], played = 0, length = 0;
+    uint64_t seed = 1070372ull;
+    double start, elapsed[2];
+
+    int plies = argc > 2 ? MIN(1000, atoi(argv[2])) : 300;
+    const int repeats = 200;
+
+    // Build a reproducible game by playing random legal moves. A
+    // game which ends early is simply thrown out and started over
+    boardFromFEN(&board, StartFEN, 0);
+    while (played < plies) {
+
+        int size = genAllLegalMoves(&board, moves);
+
+        if (size == 0 || board.numMoves >= 500) {
+            boardFromFEN(&board, StartFEN, 0);
+            played = length = 0;
+            continue;
+        }
+
+        seed ^= seed >> 12, seed ^= seed << 25, seed ^= seed >> 27;
+        uint16_t move = moves[(seed * 2685821657736338717ull >> 32) % size];
+
+        length += sprintf(game + length, " ");
+        moveToString(move, game + length, 0);
+        length += strlen(game + length);
+        ends[played++] = length;
+        applyMove(&board, move, undo);
+    }
+
+    // Send the game one ply at a time, as an interface would. The first
+    // pass extends the previous command each time. The second pass
+    // alternates between two spellings of the start position, which
+    // forces the board to be rebuilt from scratch for every command
+    for (int pass = 0; pass < 2; pass++) {
+
+        start = getRealTime();
+
+        for (int r = 0; r < repeats; r++) {
+            for (int ply = 0; ply < plies; ply++) {
+
+                int n = (pass == 1 && ply % 2)
+                      ? sprintf(command, "position fen %s moves", StartFEN)
+                      : sprintf(command, "position startpos moves");
+
+                memcpy(command + n, game, ends[ply]);
+                command[n + ends[ply]] = '\0';
+                uciPosition(command, &uciBoard, 0);
+            }
+        }
+
+        elapsed[pass] = getRealTime() - start;
+
+        if (uciBoard.hash != board.hash)
+            printf("Position mismatch after %d plies\n", plies);
+    }
+
+    printf("Incremental: %8.2f us per position command\n", 1000.0 * elapsed[0] / (repeats * plies));
+    printf("Rebuilt    : %8.2f us per position command\n", 1000.0 * elapsed[1] / (repeats * plies));
+}
+
+static uint64_t evalBenchmarkTree(Thread *thread, int depth, int evaluate, int verify, int *mismatches) {
+
+    // Evaluate every node of a full width tree. When verifying, the
+    // incrementally updated NNUE is compared against a full refresh
+
+    Board *board = &thread->board;
+    uint16_t moves[MAX_MOVES];
+    uint64_t evals = 1ull;
+
+    // Defeat the eval cache, since the tree has many transpositions
+    if (evaluate) {
+        uint64_t key = board->turn ? board->hash ^ ZobristTurnKey : board->hash;
+        thread->evtable[key & EVAL_CACHE_MASK] = 0ull;
+        evaluateBoard(thread, board);
+    }
+
+    if (verify) {
+        NNUEAccumulator *accum = board->nnue;
+        int incremental = evaluateNNUE(board);
+        board->nnue = NULL;
+        *mismatches += incremental != evaluateNNUE(board);
+        board->nnue = accum;
+    }
+
+    if (depth == 0)
+        return evals;
+
+    int size = genAllLegalMoves(board, moves);
+
+    for (int i = 0; i < size; i++) {
+        apply(thread, board, moves[i]);
+        evals += evalBenchmarkTree(thread, depth - 1, evaluate, verify, mismatches);
+        revert(thread, board, moves[i]);
+    }
+
+    return evals;
+}
+
+void runEvalBenchmark(int argc, char **argv) {
+
+    static const char *Names[] = { "None", "HCE", "NNUE", "NNUE (Refresh)" };
+
+    Board board;
+    Limits limits = {0};
+    SearchInfo info = {0};
+    Thread *thread = createThreadPool(1);
+
+    int mismatches = 0;
+    double overhead = 0.0;
+    int depth = argc > 3 ? atoi(argv[3]) : 3;
+    int modes = argc > 2 && !strEquals(argv[2], "none") ? 4 : 2;
+
+    if (modes == 4 && !initNNUE(argv[2])) {
+        printf("Unable to load %s\n", argv[2]);
+        exit(EXIT_FAILURE);
+    }
+
+    // Walk the same trees without evaluating, in order to measure the cost
+    // of the tree itself, and then with the HCE, the NNUE with incremental
+    // updates, and the NNUE refreshed from scratch for each evaluation
+
+    for (int mode = 0; mode < modes; mode++) {
+
+        uint64_t evals = 0ull;
+        double start = getRealTime();
+
+        UseNNUE = mode >= 2;
+
+        for (int i = 0; strcmp(Benchmarks[i], ""); i++) {
+            boardFromFEN(&board, Benchmarks[i], 0);
+            newSearchThreadPool(thread, &board, &limits, &info);
+            if (mode == 3) thread->board.nnue = NULL;
+            resetThreadPool(thread);
+            evals += evalBenchmarkTree(thread, depth, mode != 0, 0, &mismatches);
+        }
+
+        double elapsed = getRealTime() - start;
+        if (mode == 0) overhead = elapsed;
+
+        printf("%-16s %12"PRIu64" nodes %8d ms %10d evals/s\n", Names[mode], evals, (int)elapsed,
+            mode == 0 ? 0 : (int)(1000.0 * evals / MAX(1.0, elapsed - overhead)));
+    }
+
+    if (modes == 2) {
+        free(thread);
+        return;
+    }
+
+    for (int i = 0; strcmp(Benchmarks[i], ""); i++) {
+        boardFromFEN(&board, Benchmarks[i], 0);
+        newSearchThreadPool(thread, &board, &limits, &info);
+        evalBenchmarkTree(thread, MIN(depth, 2), 1, 1, &mismatches);
+    }
+
+    printf("Incremental updates mismatched a full refresh %d times\n", mismatches);
+
+    free(thread);
+}
+
+static void randomEndgameFEN(EGNetwork *nn, uint64_t *seed, char *fen) {
+
+    // Kings, one of each of the Network's pieces for each side, and up to
+    // five Pawns each on the 2nd to 7th ranks. Legality does not matter here
+
+    char squares[SQUARE_NB];
+    memset(squares, 0, sizeof(squares));
+
+    for (int colour = WHITE; colour <= BLACK; colour++) {
+        for (int type = PAWN; type <= KING; type++) {
+
+            if (!(nn->pieces & (1 << type)))
+                continue;
+
+            int count = type != PAWN ? 1 : (int)(*seed % 6);
+
+            for (int i = 0; i < count; i++) {
+
+                int sq;
+
+                do {
+                    *seed ^= *seed >> 12, *seed ^= *seed << 25, *seed ^= *seed >> 27;
+                    sq = (*seed * 2685821657736338717ull >> 32) % SQUARE_NB;
+                } while (squares[sq] || (type == PAWN && (sq < 8 || sq >= 56)));
+
+                squares[sq] = PieceLabel[colour][type];
+            }
+        }
+    }
+
+    for (int rank = RANK_NB - 1; rank >= 0; rank--) {
+        for (int file = 0, empty = 0; file < FILE_NB; file++) {
+            empty += !squares[square(rank, file)];
+            if (squares[square(rank, file)] || file == FILE_NB - 1) {
+                if (empty) *fen++ = '0' + empty, empty = 0;
+                if (squares[square(rank, file)]) *fen++ = squares[square(rank, file)];
+            }
+        }
+        *fen++ = rank ? '/' : ' ';
+    }
+
+    strcpy(fen, "w - - 0 1");
+}
+
+void runEndgameBenchmark(int argc, char **argv) {
+
+    extern EGNetwork EGNetworks[NN_EG_COUNT];
+
+    char fen[128];
+    NNCacheEntry entry = {0};
+    uint64_t seed = 1070372ull;
+    volatile int sink = 0;
+
+    int count = argc > 2 ? atoi(argv[2]) : 1000;
+    const int repeats = 2000;
+
+    Board *boards = malloc(sizeof(Board) * count);
+
+    printf("Network          Miss ns/eval   Hit ns/eval   evaluateEndgames() ns/eval\n");
+
+    for (int i = 0; i < NN_EG_COUNT; i++) {
+
+        EGNetwork *nn = &EGNetworks[i];
+        double start, elapsed[3];
+
+        for (int j = 0; j < count; j++) {
+            randomEndgameFEN(nn, &seed, fen);
+            boardFromFEN(&boards[j], fen, 0);
+        }
+
+        // A miss computes the Pawn King Neurons before the rest
+        start = getRealTime();
+        for (int r = 0; r < repeats; r++)
+            for (int j = 0; j < count; j++) {
+                computeEndgameNeurons(nn, &entry, &boards[j]);
+                sink += evaluateEndgameNN(nn, &entry, &boards[j]);
+            }
+        elapsed[0] = getRealTime() - start;
+
+        // A hit only adds the Network's own pieces to the cached Neurons
+        start = getRealTime();
+        for (int r = 0; r < repeats; r++)
+            for (int j = 0; j < count; j++)
+                sink += evaluateEndgameNN(nn, &entry, &boards[j]);
+        elapsed[1] = getRealTime() - start;
+
+        // The full path, with dispatch on the material key and the cache
+        start = getRealTime();
+        for (int r = 0; r < repeats; r++)
+            for (int j = 0; j < count; j++)
+                sink += evaluateEndgames(&boards[j], endgameNetworkIndex(&boards[j]));
+        elapsed[2] = getRealTime() - start;
+
+        printf("%-16s %13.1f %13.1f %28.1f\n", nn->name,
+            1e6 * elapsed[0] / ((double) repeats * count),
+            1e6 * elapsed[1] / ((double) repeats * count),
+            1e6 * elapsed[2] / ((double) repeats * count));
+    }
+
+    free(boards);
+}
+
+void runWeightsBenchmark(int argc, char **argv) {
+
+    const int repeats = 1000;
+    double start, elapsed;
+
+    // Loading the embedded networks only validates and looks up sections.
+    // Reloading also clears the EG caches, which startup does not need to
+    start = getRealTime();
+    for (int i = 0; i < repeats; i++)
+        initWeights(NULL);
+    elapsed = getRealTime() - start;
+    printf("Embedded    : %8.2f us per load\n", 1000.0 * elapsed / repeats);
+
+    if (argc <= 2) return;
+
+    // Loading a file adds the cost of mapping it into memory
+    start = getRealTime();
+    for (int i = 0; i < repeats; i++)
+        if (!initWeights(argv[2])) {
+            printf("Unable to load %s\n", argv[2]);
+            return;
+        }
+    elapsed = getRealTime() - start;
+    printf("File        : %8.2f us per load\n", 1000.0 * elapsed / repeats);
+}
+
+void runPerftSuite(int argc, char **argv) {
+
+    // Each line is a FEN followed by the expected results, in the format
+    // "<fen> ;D1 20 ;D2 400 ;D3 8902", as found in standard and fischer.epd
+
+    Board board;
+    FILE *fin;
+    char line[1024];
+
+    int maxDepth  = argc > 3 ? atoi(argv[3]) :  5;
+    int nthreads  = argc > 4 ? atoi(argv[4]) :  1;
+    int megabytes = argc > 5 ? atoi(argv[5]) : 16;
+    int positions = 0, unchecked = 0, checked = 0, failed = 0;
+    uint64_t totalNodes = 0ull;
+
+    if ((fin = fopen(argv[2], "r")) == NULL) {
+        printf("Unable to open %s\n", argv[2]);
+        exit(EXIT_FAILURE);
+    }
+
+    double start = getRealTime();
+
+    while (fgets(line, sizeof(line), fin) != NULL) {
+
+        char *ptr = strchr(line, ';');
+        if (ptr == NULL) continue;
+
+        *ptr++ = '\0';
+        boardFromFEN(&board, line, 0);
+        positions++;
+
+        // Check every depth given, up to the requested maximum
+        int counts = checked;
+        for (ptr = strstr(ptr, "D"); ptr != NULL; ptr = strstr(ptr, "D")) {
+
+            int depth = strtol(ptr + 1, &ptr, 10);
+            uint64_t expected = strtoull(ptr, &ptr, 10);
+
+            if (depth > maxDepth) break;
+
+            uint64_t found = perftThreaded(&board, depth, nthreads, megabytes, PERFT_QUIET);
+            totalNodes += found, checked++;
+
+            if (found != expected) {
+                printf("Perft [# %4d] D%d expected %"PRIu64" found %"PRIu64" : %s\n",
+                    positions, depth, expected, found, line);
+                failed++;
+            }
+        }
+
+        // Positions whose every count lies beyond the maximum depth
+        if (counts == checked) {
+            printf("Perft [# %4d] No count at or below D%d : %s\n", positions, maxDepth, line);
+            unchecked++;
+        }
+    }
+
+    fclose(fin);
+
+    double elapsed = getRealTime() - start;
+    printf("Perft Suite : %d positions (%d unchecked), %d counts passed, %d counts failed\n",
+        positions, unchecked, checked - failed, failed);
+    printf("OVERALL: %"PRIu64" nodes %d ms %"PRIu64" nps\n",
+        totalNodes, (int)elapsed, (uint64_t)(1000.0 * totalNodes / (elapsed + 1)));
+
+    // An empty suite, or a depth below every count, verifies nothing
+    if (failed || checked == 0) exit(EXIT_FAILURE);
+}
+
+static uint64_t microNoisy(Board *boards, int nboards, uint64_t *sink) {
+    uint16_t moves[MAX_MOVES];
+    for (int i = 0; i < nboards; i++)
+        *sink += genAllNoisyMoves(&boards[i], moves);
+    return nboards;
+}
+
+static uint64_t microQuiet(Board *boards, int nboards, uint64_t *sink) {
+    uint16_t moves[MAX_MOVES];
+    for (int i = 0; i < nboards; i++)
+        *sink += genAllQuietMoves(&boards[i], moves);
+    return nboards;
+}
+
+static uint64_t microApplyRevert(Board *boards, int nboards, uint64_t *sink) {
+
+    Undo undo[1];
+    uint64_t ops = 0ull;
+    uint16_t moves[MAX_MOVES];
+
+    for (int i = 0; i < nboards; i++) {
+        int size = genAllLegalMoves(&boards[i], moves);
+        for (int j = 0; j < size; j++, ops++) {
+            applyMove(&boards[i], moves[j], undo);
+            *sink += boards[i].hash;
+            revertMove(&boards[i], moves[j], undo);
+        }
+    }
+
+    return ops;
+}
+
+static uint64_t microSEE(Board *boards, int nboards, uint64_t *sink) {
+
+    uint64_t ops = 0ull;
+    uint16_t moves[MAX_MOVES];
+
+    for (int i = 0; i < nboards; i++) {
+        int size = genAllNoisyMoves(&boards[i], moves);
+        for (int j = 0; j < size; j++, ops++)
+            *sink += staticExchangeEvaluation(&boards[i], moves[j], 0);
+    }
+
+    return ops;
+}
+
+static uint64_t microEvaluate(Board *boards, int nboards, uint64_t *sink, Thread *thread) {
+
+    // Each pass starts from an empty evaluation cache, so that every
+    // call is a full evaluation. The Pawn King and Material tables are
+    // left alone, as they hit the vast majority of the time in a search
+
+    memset(&thread->evtable, 0, sizeof(EvalTable));
+
+    for (int i = 0; i < nboards; i++)
+        *sink += evaluateBoard(thread, &boards[i]);
+
+    return nboards;
+}
+
+static uint64_t microProbeTT(Board *boards, int nboards, uint64_t *sink) {
+
+    uint16_t move;
+    int value, eval, depth, bound;
+
+    for (int i = 0; i < nboards; i++)
+        *sink += getTTEntry(boards[i].hash, &move, &value, &eval, &depth, &bound);
+
+    return nboards;
+}
+
+static uint64_t microSliders(Board *boards, int nboards, uint64_t *sink) {
+
+    for (int i = 0; i < nboards; i++) {
+        uint64_t occupied = boards[i].colours[WHITE] | boards[i].colours[BLACK];
+        for (int sq = 0; sq < SQUARE_NB; sq++)
+            *sink ^= bishopAttacks(sq, occupied) ^ rookAttacks(sq, occupied);
+    }
+
+    return 2 * SQUARE_NB * nboards;
+}
+
+static uint64_t microSlidersCold(Board *boards, int nboards, uint64_t *sink, uint64_t *scratch, uint64_t mask) {
+
+    // Each pair of lookups is preceded by a write to a random line of a
+    // buffer much larger than the caches, as the Transposition Table and
+    // history tables would do in a search, to compete with the tables
+
+    uint64_t seed = *sink | 1ull;
+
+    for (int i = 0; i < nboards; i++) {
+        uint64_t occupied = boards[i].colours[WHITE] | boards[i].colours[BLACK];
+        for (int sq = 0; sq < SQUARE_NB; sq++) {
+            seed ^= seed << 13, seed ^= seed >> 7, seed ^= seed << 17;
+            scratch[(seed & mask) * 8] += sq;
+            *sink ^= bishopAttacks(sq, occupied) ^ rookAttacks(sq, occupied);
+        }
+    }
+
+    return 2 * SQUARE_NB * nboards;
+}
+
+static uint64_t microMovePicker(Board *boards, int nboards, uint64_t *sink, Thread *thread, int limit) {
+
+    // Select up to limit moves from each position, as a node which cuts
+    // off early would, or every move, as a node which never cuts off would
+
+    MovePicker mp;
+    uint16_t move;
+    uint64_t ops = 0ull;
+
+    for (int i = 0; i < nboards; i++) {
+
+        memcpy(&thread->board, &boards[i], BOARD_HOT_SIZE);
+        initMovePicker(&mp, thread, NONE_MOVE);
+
+        for (int j = 0; j < limit && (move = selectNextMove(&mp, &thread->board, 0)) != NONE_MOVE; j++)
+            *sink += move, ops++;
+    }
+
+    return ops;
+}
+
+static void seedHistories(Thread *thread) {
+
+    // Scores spread over much of their range, so that the Move Picker
+    // is not handed a list which is already sorted, as empty tables are
+
+    int16_t *tables[] = { (int16_t *) thread->history, (int16_t *) thread->continuation, (int16_t *) thread->chistory };
+    size_t lengths[] = { sizeof(HistoryTable), sizeof(ContinuationTable), sizeof(CaptureHistoryTable) };
+
+    for (int i = 0; i < 3; i++)
+        for (size_t j = 0; j < lengths[i] / sizeof(int16_t); j++)
+            tables[i][j] = (int) (rand64() % 16384) - 8192;
+}
+
+void runMicroBenchmark(int argc, char **argv) {
+
+    static const char *Names[] = {
+        "genAllNoisyMoves", "genAllQuietMoves", "applyMove/revertMove",
+        "staticExchangeEvaluation", "evaluateBoard", "getTTEntry", "bishop/rookAttacks",
+        "bishop/rookAttacks (cold)", "selectNextMove (first 4)", "selectNextMove (all)",
+    };
+
+    const uint64_t ScratchLines = 1ull << 20; // 64MB of Cache Lines
+
+    Board board, *boards;
+    Thread *thread = createThreadPool(1);
+    Undo undo[1];
+    uint16_t moves[MAX_MOVES];
+
+    int nboards = 0;
+    uint64_t sink = 0ull;
+    double duration = argc > 2 ? atoi(argv[2]) : 500;
+
+    // Use the Benchmark positions, and each position one legal move away,
+    // so that the kernels see a mix of positions much like a search would
+    for (int i = 0; strcmp(Benchmarks[i], ""); i++) {
+        boardFromFEN(&board, Benchmarks[i], 0);
+        nboards += 1 + genAllLegalMoves(&board, moves);
+    }
+
+    boards = malloc(sizeof(Board) * nboards), nboards = 0;
+
+    for (int i = 0; strcmp(Benchmarks[i], ""); i++) {
+
+        boardFromFEN(&boards[nboards], Benchmarks[i], 0);
+        int size = genAllLegalMoves(&boards[nboards], moves);
+        Board *root = &boards[nboards++];
+
+        for (int j = 0; j < size; j++) {
+            boards[nboards] = *root;
+            applyMove(&boards[nboards++], moves[j], undo);
+        }
+    }
+
+    // Fill the Transposition Table with half of the positions
+    for (int i = 0; i < nboards; i += 2)
+        storeTTEntry(boards[i].hash, NONE_MOVE, 0, 0, 1, BOUND_EXACT);
+
+    // Buffer used to evict the slider tables between lookups
+    uint64_t *scratch = calloc(ScratchLines * 8, sizeof(uint64_t));
+
+    resetThreadPool(thread);
+    seedHistories(thread);
+    printf("Timing %d positions for at least %d ms per kernel\n", nboards, (int)duration);
+    printf("Using %s\n\n", cpuDescription());
+
+    for (int kernel = 0; kernel < 10; kernel++) {
+
+        uint64_t ops = 0ull;
+        double start = getRealTime(), elapsed;
+
+        do {
+            switch (kernel) {
+                case 0: ops += microNoisy(boards, nboards, &sink); break;
+                case 1: ops += microQuiet(boards, nboards, &sink); break;
+                case 2: ops += microApplyRevert(boards, nboards, &sink); break;
+                case 3: ops += microSEE(boards, nboards, &sink); break;
+                case 4: ops += microEvaluate(boards, nboards, &sink, thread); break;
+                case 5: ops += microProbeTT(boards, nboards, &sink); break;
+                case 6: ops += microSliders(boards, nboards, &sink); break;
+                case 7: ops += microSlidersCold(boards, nboards, &sink, scratch, ScratchLines - 1); break;
+                case 8: ops += microMovePicker(boards, nboards, &sink, thread, 4); break;
+                case 9: ops += microMovePicker(boards, nboards, &sink, thread, MAX_MOVES); break;
+            }
+        } while ((elapsed = getRealTime() - start) < duration);
+
+        printf("%-26s %12"PRIu64" ops %10.2f ns/op %14.0f ops/s\n",
+            Names[kernel], ops, 1e6 * elapsed / ops, 1000.0 * ops / elapsed);
+    }
+
+    // Printing the sink keeps the compiler from discarding any work
+    printf("\nChecksum %"PRIx64"\n", sink);
+
+    free(scratch);
+    free(boards);
+    free(thread);
 }
 
 void runEvalBook(int argc, char **argv) {
@@ -137,12 +876,15 @@ void runEvalBook(int argc, char **argv) {
     int depth     = argc > 3 ? atoi(argv[3]) : 12;
     int nthreads  = argc > 4 ? atoi(argv[4]) :  1;
     int megabytes = argc > 5 ? atoi(argv[5]) :  2;
+    uint64_t nlimit = argc > 6 ? strtoull(argv[6], NULL, 10) : 0ull;
 
     Thread *threads = createThreadPool(nthreads);
 
     limits.multiPV = 1;
     limits.limitedByDepth = 1;
     limits.depthLimit = depth;
+    limits.limitedByNodes = nlimit != 0;
+    limits.nodeLimit = nlimit;
     initTT(megabytes);
 
     while ((fgets(line, 256, book)) != NULL) {
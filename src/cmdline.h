@@ -20,4 +20,11 @@
 
 void handleCommandLine(int argc, char **argv);
 void runBenchmark(int argc, char **argv);
+void runMateBenchmark(int argc, char **argv);
+void runPositionBenchmark(int argc, char **argv);
+void runEvalBenchmark(int argc, char **argv);
+void runEndgameBenchmark(int argc, char **argv);
+void runWeightsBenchmark(int argc, char **argv);
+void runPerftSuite(int argc, char **argv);
+void runMicroBenchmark(int argc, char **argv);
 void runEvalBook(int argc, char **argv);
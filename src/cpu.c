@@ -0,0 +1,109 @@
+/*
+  Ethereal is a UCI chess playing engine authored by Andrew Grant.
+  <https://github.com/AndyGrant/Ethereal>     <andrew@grantnet.us>
+
+  Ethereal is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Ethereal is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "attacks.h"
+#include "cpu.h"
+#include "pairs.h"
+
+int CPUPopcnt, CPUPext, CPUSimd, CPUPairs;
+
+void initCPU() {
+
+#if defined(USE_DISPATCH)
+
+    // Select kernels based on what the CPU reports via cpuid. Zen 1 & 2, as
+    // well as the older AMD chips with BMI2, microcode PEXT and are left on
+    // Magics. ETHEREAL_DISABLE_CPU="popcnt pext sse4.1 avx2 avx512" may be
+    // used to force the slower paths, when comparing against specialized builds
+
+    const char *disabled = getenv("ETHEREAL_DISABLE_CPU");
+    if (disabled == NULL) disabled = "";
+
+    __builtin_cpu_init();
+
+    CPUPopcnt = __builtin_cpu_supports("popcnt")
+             && !strstr(disabled, "popcnt");
+
+    CPUPext   = __builtin_cpu_supports("bmi2")
+             && !__builtin_cpu_is("amdfam15h")
+             && !__builtin_cpu_is("amdfam17h")
+             && !strstr(disabled, "pext");
+
+    CPUSimd   = SIMD_GENERIC;
+
+    if (__builtin_cpu_supports("sse4.1") && !strstr(disabled, "sse4.1")) {
+        CPUSimd = SIMD_SSE41;
+        if (__builtin_cpu_supports("avx2") && !strstr(disabled, "avx2"))
+            CPUSimd = SIMD_AVX2;
+    }
+
+    CPUPairs  = __builtin_cpu_supports("avx512vpopcntdq")
+             && __builtin_cpu_supports("avx512vl")
+             && __builtin_cpu_supports("avx512dq")
+             && !strstr(disabled, "avx512");
+
+#else
+
+    // Specialized builds report what they were compiled for
+
+    #if defined(__POPCNT__)
+        CPUPopcnt = 1;
+    #endif
+
+    #if defined(USE_PEXT)
+        CPUPext = 1;
+    #endif
+
+    #if defined(__AVX2__)
+        CPUSimd = SIMD_AVX2;
+    #elif defined(__SSE4_1__)
+        CPUSimd = SIMD_SSE41;
+    #else
+        CPUSimd = SIMD_GENERIC;
+    #endif
+
+    #if defined(USE_PAIRS)
+        CPUPairs = 1;
+    #endif
+
+#endif
+}
+
+const char *cpuDescription() {
+
+    static char description[128];
+    static const char *SimdNames[] = { "Generic", "SSE4.1", "AVX2" };
+
+#if defined(USE_DISPATCH)
+    const char *mode = "dispatched";
+#else
+    const char *mode = "compiled";
+#endif
+
+    snprintf(description, sizeof(description),
+        "popcount %s, sliders %s, networks %s, evaluation %s (%s)",
+        CPUPopcnt ? "POPCNT" : "Software", SLIDER_BACKEND, SimdNames[CPUSimd],
+        CPUPairs ? "AVX-512 Pairs" : "Scalar", mode);
+
+    return description;
+}
@@ -0,0 +1,32 @@
+/*
+  Ethereal is a UCI chess playing engine authored by Andrew Grant.
+  <https://github.com/AndyGrant/Ethereal>     <andrew@grantnet.us>
+
+  Ethereal is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Ethereal is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include "types.h"
+
+enum { SIMD_GENERIC, SIMD_SSE41, SIMD_AVX2 };
+
+extern int CPUPopcnt; // Hardware popcount, else the software fallback
+extern int CPUPext;   // PEXT slider indexing, else the Magic multiply
+extern int CPUSimd;   // Widest SIMD kernels used by the Networks
+extern int CPUPairs;  // AVX-512 paired evaluation of Threats and Space
+
+void initCPU();
+const char *cpuDescription();
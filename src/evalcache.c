@@ -13,15 +13,22 @@
   along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <assert.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
+#include "bitboards.h"
 #include "board.h"
 #include "evaluate.h"
 #include "thread.h"
 #include "types.h"
 #include "zobrist.h"
 
+static SharedPKEntry *SharedPKTable; // Optional, used by all Threads when set
+static uint64_t SharedPKMask;
+static const uint64_t MB = 1ull << 20;
+
 int getCachedEvaluation(Thread *thread, Board *board, int *eval) {
 
     EvalEntry eve;
@@ -42,13 +49,121 @@ void storeCachedEvaluation(Thread *thread, Board *board, int eval) {
 }
 
 
+static PKEntry* getSharedPawnKingEval(Thread *thread, Board *board) {
+
+    // Entries are written by many Threads without locking, so the key is
+    // never stored directly. Instead we store the key XOR'ed with the data,
+    // so that an entry torn by a concurrent store fails to verify. Verified
+    // entries are copied out, since the slot may be overwritten at any time
+
+    SharedPKEntry *spke = &SharedPKTable[board->pkhash & SharedPKMask];
+    uint64_t scores = spke->scores, passed = spke->passed;
+    uint64_t check  = spke->check ^ scores ^ passed;
+
+    // Only the upper 48 bits of the key are kept, leaving room for
+    // half of the Black safety score, with the other half in passed
+    if ((check ^ board->pkhash) >> 16)
+        return NULL;
+
+    thread->pkshared = (PKEntry) {
+        board->pkhash, (passed << 16) >> 8,
+        (int) (uint32_t) scores, (int) (uint32_t) (scores >> 32),
+        (int) ((uint32_t) (check & 0xFFFF) << 16 | (uint32_t) (passed >> 48))
+    };
+
+    return &thread->pkshared;
+}
+
+static void storeSharedPawnKingEval(Board *board, uint64_t passed, int eval, int safetyw, int safetyb) {
+
+    // Passed Pawns never sit on the back ranks, so the bitboard
+    // fits into the lower 48 bits once shifted down by a rank
+
+    SharedPKEntry *spke = &SharedPKTable[board->pkhash & SharedPKMask];
+    uint64_t scores = (uint32_t) eval | ((uint64_t) (uint32_t) safetyw << 32);
+    uint64_t check  = (board->pkhash & ~0xFFFFull) | ((uint32_t) safetyb >> 16);
+
+    assert(!(passed & PROMOTION_RANKS));
+    passed = (passed >> 8) | ((uint64_t) ((uint32_t) safetyb & 0xFFFF) << 48);
+
+    *spke = (SharedPKEntry) { check ^ scores ^ passed, scores, passed };
+}
+
 PKEntry* getCachedPawnKingEval(Thread *thread, Board *board) {
+
+    if (SharedPKTable != NULL)
+        return getSharedPawnKingEval(thread, board);
+
     PKEntry *pke = &thread->pktable[board->pkhash & PK_CACHE_MASK];
     return pke->pkhash == board->pkhash ? pke : NULL;
 }
 
 void storeCachedPawnKingEval(Thread *thread, Board *board, uint64_t passed, int eval, int safetyw, int safetyb) {
+
+    if (SharedPKTable != NULL) {
+        storeSharedPawnKingEval(board, passed, eval, safetyw, safetyb);
+        return;
+    }
+
     PKEntry *pke = &thread->pktable[board->pkhash & PK_CACHE_MASK];
     *pke = (PKEntry) {board->pkhash, passed, eval, safetyw, safetyb};
 }
 
+
+void initPKTables(Thread *threads) {
+
+    // Each Thread has its own PKTable, unless all of them share one, in
+    // which case the per-Thread tables are released to save the memory
+
+    for (int i = 0; i < threads->nthreads; i++) {
+
+        if (SharedPKTable != NULL) {
+            free(threads[i].pktable);
+            threads[i].pktable = NULL;
+        }
+
+        else if (threads[i].pktable == NULL) {
+            threads[i].pktable = aligned_alloc(64, sizeof(PKTable));
+            memset(threads[i].pktable, 0, sizeof(PKTable));
+        }
+    }
+}
+
+void freePKTables(Thread *threads) {
+    for (int i = 0; i < threads->nthreads; i++)
+        free(threads[i].pktable), threads[i].pktable = NULL;
+}
+
+void initSharedPKTable(Thread *threads, uint64_t megabytes) {
+
+    // Setting the size to zero returns to the per-Thread PKTables.
+    // Otherwise, use the largest power of two entries which fits
+
+    uint64_t entries = 1;
+
+    free(SharedPKTable);
+    SharedPKTable = NULL, SharedPKMask = 0ull;
+
+    if (megabytes != 0) {
+
+        while (2 * entries * sizeof(SharedPKEntry) <= megabytes * MB)
+            entries *= 2;
+
+        SharedPKTable = aligned_alloc(64, entries * sizeof(SharedPKEntry));
+        SharedPKMask  = entries - 1;
+
+        clearSharedPKTable();
+    }
+
+    initPKTables(threads);
+}
+
+void clearSharedPKTable() {
+    if (SharedPKTable != NULL)
+        memset(SharedPKTable, 0, (SharedPKMask + 1) * sizeof(SharedPKEntry));
+}
+
+int sharedPKTableSizeMB() {
+    return SharedPKTable == NULL ? 0 : ((SharedPKMask + 1) * sizeof(SharedPKEntry)) / MB;
+}
+
@@ -38,9 +38,17 @@ typedef EvalEntry EvalTable[EVAL_CACHE_SIZE];
 struct PKEntry { uint64_t pkhash, passed; int eval, safetyw, safetyb; };
 typedef PKEntry PKTable[PK_CACHE_SIZE];
 
+struct SharedPKEntry { uint64_t check, scores, passed; };
+
 int getCachedEvaluation(Thread *thread, Board *board, int *eval);
 void storeCachedEvaluation(Thread *thread, Board *board, int eval);
 
 PKEntry* getCachedPawnKingEval(Thread *thread, Board *board);
 void storeCachedPawnKingEval(Thread *thread, Board *board, uint64_t passed, int eval, int safetyw, int safetyb);
 
+void initPKTables(Thread *threads);
+void freePKTables(Thread *threads);
+void initSharedPKTable(Thread *threads, uint64_t megabytes);
+void clearSharedPKTable();
+int sharedPKTableSizeMB();
+
@@ -16,19 +16,25 @@
   along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <stddef.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 
 #include "attacks.h"
+#include "bitbase.h"
 #include "bitboards.h"
 #include "board.h"
 #include "evalcache.h"
 #include "evaluate.h"
 #include "move.h"
 #include "masks.h"
+#include "material.h"
 #include "network.h"
 #include "nneval.h"
+#include "nnue.h"
+#include "pairs.h"
 #include "thread.h"
 #include "transposition.h"
 #include "types.h"
@@ -38,403 +44,407 @@ int PSQT[32][SQUARE_NB];
 
 #define S(mg, eg) (MakeScore((mg), (eg)))
 
-/* Material Value Evaluation Terms */
-
-const int PawnValue   = S(  82, 144);
-const int KnightValue = S( 426, 475);
-const int BishopValue = S( 441, 510);
-const int RookValue   = S( 627, 803);
-const int QueenValue  = S(1292,1623);
-const int KingValue   = S(   0,   0);
-
-/* Piece Square Evaluation Terms */
-
-const int PawnPSQT[SQUARE_NB] = {
-    S(   0,   0), S(   0,   0), S(   0,   0), S(   0,   0),
-    S(   0,   0), S(   0,   0), S(   0,   0), S(   0,   0),
-    S( -13,   7), S(  -4,   0), S(   1,   4), S(   6,   1),
-    S(   3,  10), S(  -9,   4), S(  -9,   3), S( -16,   7),
-    S( -21,   5), S( -17,   6), S(  -1,  -6), S(  12, -14),
-    S(   8, -10), S(  -4,  -5), S( -15,   7), S( -24,  11),
-    S( -14,  16), S( -21,  17), S(   9, -10), S(  10, -24),
-    S(   4, -22), S(   4, -10), S( -20,  17), S( -17,  18),
-    S( -15,  18), S( -18,  11), S( -16,  -8), S(   4, -30),
-    S(  -2, -24), S( -18,  -9), S( -23,  13), S( -17,  21),
-    S( -20,  48), S(  -9,  44), S(   1,  31), S(  17,  -9),
-    S(  36,  -6), S(  -9,  31), S(  -6,  45), S( -23,  49),
-    S( -33, -70), S( -66,  -9), S( -16, -22), S(  65, -23),
-    S(  41, -18), S(  39, -14), S( -47,   4), S( -62, -51),
-    S(   0,   0), S(   0,   0), S(   0,   0), S(   0,   0),
-    S(   0,   0), S(   0,   0), S(   0,   0), S(   0,   0),
+ALIGN64 EvalParams Params = {
+
+    /* Material Value Evaluation Terms */
+
+    .PawnValue   = S(  82, 144),
+    .KnightValue = S( 426, 475),
+    .BishopValue = S( 441, 510),
+    .RookValue   = S( 627, 803),
+    .QueenValue  = S(1292,1623),
+    .KingValue   = S(   0,   0),
+
+    /* Piece Square Evaluation Terms */
+
+    .PawnPSQT = {
+        S(   0,   0), S(   0,   0), S(   0,   0), S(   0,   0),
+        S(   0,   0), S(   0,   0), S(   0,   0), S(   0,   0),
+        S( -13,   7), S(  -4,   0), S(   1,   4), S(   6,   1),
+        S(   3,  10), S(  -9,   4), S(  -9,   3), S( -16,   7),
+        S( -21,   5), S( -17,   6), S(  -1,  -6), S(  12, -14),
+        S(   8, -10), S(  -4,  -5), S( -15,   7), S( -24,  11),
+        S( -14,  16), S( -21,  17), S(   9, -10), S(  10, -24),
+        S(   4, -22), S(   4, -10), S( -20,  17), S( -17,  18),
+        S( -15,  18), S( -18,  11), S( -16,  -8), S(   4, -30),
+        S(  -2, -24), S( -18,  -9), S( -23,  13), S( -17,  21),
+        S( -20,  48), S(  -9,  44), S(   1,  31), S(  17,  -9),
+        S(  36,  -6), S(  -9,  31), S(  -6,  45), S( -23,  49),
+        S( -33, -70), S( -66,  -9), S( -16, -22), S(  65, -23),
+        S(  41, -18), S(  39, -14), S( -47,   4), S( -62, -51),
+        S(   0,   0), S(   0,   0), S(   0,   0), S(   0,   0),
+        S(   0,   0), S(   0,   0), S(   0,   0), S(   0,   0),
+    },
+
+    .KnightPSQT = {
+        S( -31, -38), S(  -6, -24), S( -20, -22), S( -16,  -1),
+        S( -11,  -1), S( -22, -19), S(  -8, -20), S( -41, -30),
+        S(   1,  -5), S( -11,   3), S(  -6, -19), S(  -1,  -2),
+        S(   0,   0), S(  -9, -16), S(  -8,  -3), S(  -6,   1),
+        S(   7, -21), S(   8,  -5), S(   7,   2), S(  10,  19),
+        S(  10,  19), S(   4,   2), S(   8,  -4), S(   3, -19),
+        S(  16,  21), S(  17,  30), S(  23,  41), S(  27,  50),
+        S(  24,  53), S(  23,  41), S(  19,  28), S(  13,  26),
+        S(  13,  30), S(  23,  30), S(  37,  51), S(  30,  70),
+        S(  26,  67), S(  38,  50), S(  22,  33), S(  14,  28),
+        S( -24,  25), S(  -5,  37), S(  25,  56), S(  22,  60),
+        S(  27,  55), S(  29,  55), S(  -1,  32), S( -19,  25),
+        S(  13,  -2), S( -11,  18), S(  27,  -2), S(  37,  24),
+        S(  41,  24), S(  40,  -7), S( -13,  16), S(   2,  -2),
+        S(-167,  -5), S( -91,  12), S(-117,  41), S( -38,  17),
+        S( -18,  19), S(-105,  48), S(-119,  24), S(-165, -17),
+    },
+
+    .BishopPSQT = {
+        S(   5, -21), S(   1,   1), S(  -1,   5), S(   1,   5),
+        S(   2,   8), S(  -6,  -2), S(   0,   1), S(   4, -25),
+        S(  26, -17), S(   2, -31), S(  15,  -2), S(   8,   8),
+        S(   8,   8), S(  13,  -3), S(   9, -31), S(  26, -29),
+        S(   9,   3), S(  22,   9), S(  -5,  -3), S(  18,  19),
+        S(  17,  20), S(  -5,  -6), S(  20,   4), S(  15,   8),
+        S(   0,  12), S(  10,  17), S(  17,  32), S(  20,  32),
+        S(  24,  34), S(  12,  30), S(  15,  17), S(   0,  14),
+        S( -20,  34), S(  13,  31), S(   1,  38), S(  21,  45),
+        S(  12,  46), S(   6,  38), S(  13,  33), S( -14,  37),
+        S( -13,  31), S( -11,  45), S(  -7,  23), S(   2,  40),
+        S(   8,  38), S( -21,  34), S(  -5,  46), S(  -9,  35),
+        S( -59,  38), S( -49,  22), S( -13,  30), S( -35,  36),
+        S( -33,  36), S( -13,  33), S( -68,  21), S( -55,  35),
+        S( -66,  18), S( -65,  36), S(-123,  48), S(-107,  56),
+        S(-112,  53), S( -97,  43), S( -33,  22), S( -74,  15),
+    },
+
+    .RookPSQT = {
+        S( -26,  -1), S( -21,   3), S( -14,   4), S(  -6,  -4),
+        S(  -5,  -4), S( -10,   3), S( -13,  -2), S( -22, -14),
+        S( -70,   5), S( -25, -10), S( -18,  -7), S( -11, -11),
+        S(  -9, -13), S( -15, -15), S( -15, -17), S( -77,   3),
+        S( -39,   3), S( -16,  14), S( -25,   9), S( -14,   2),
+        S( -12,   3), S( -25,   8), S(  -4,   9), S( -39,   1),
+        S( -32,  24), S( -21,  36), S( -21,  36), S(  -5,  26),
+        S(  -8,  27), S( -19,  34), S( -13,  33), S( -30,  24),
+        S( -22,  46), S(   4,  38), S(  16,  38), S(  35,  30),
+        S(  33,  32), S(  10,  36), S(  17,  31), S( -14,  43),
+        S( -33,  60), S(  17,  41), S(   0,  54), S(  33,  36),
+        S(  29,  35), S(   3,  52), S(  33,  32), S( -26,  56),
+        S( -18,  41), S( -24,  47), S(  -1,  38), S(  15,  38),
+        S(  14,  37), S(  -2,  36), S( -24,  49), S( -12,  38),
+        S(  33,  55), S(  24,  63), S(  -1,  73), S(   9,  66),
+        S(  10,  67), S(   0,  69), S(  34,  59), S(  37,  56),
+    },
+
+    .QueenPSQT = {
+        S(  20, -34), S(   4, -26), S(   9, -34), S(  17, -16),
+        S(  18, -18), S(  14, -46), S(   9, -28), S(  22, -44),
+        S(   6, -15), S(  15, -22), S(  22, -42), S(  13,   2),
+        S(  17,   0), S(  22, -49), S(  18, -29), S(   3, -18),
+        S(   6,  -1), S(  21,   7), S(   5,  35), S(   0,  34),
+        S(   2,  34), S(   5,  37), S(  24,   9), S(  13, -15),
+        S(   9,  17), S(  12,  46), S(  -6,  59), S( -19, 109),
+        S( -17, 106), S(  -4,  57), S(  18,  48), S(   8,  33),
+        S( -10,  42), S(  -8,  79), S( -19,  66), S( -32, 121),
+        S( -32, 127), S( -23,  80), S(  -8,  95), S( -10,  68),
+        S( -28,  56), S( -23,  50), S( -33,  66), S( -18,  70),
+        S( -17,  71), S( -19,  63), S( -18,  65), S( -28,  76),
+        S( -16,  61), S( -72, 108), S( -19,  65), S( -52, 114),
+        S( -54, 120), S( -14,  59), S( -69, 116), S( -11,  73),
+        S(   8,  43), S(  19,  47), S(   0,  79), S(   3,  78),
+        S(  -3,  89), S(  13,  65), S(  18,  79), S(  21,  56),
+    },
+
+    .KingPSQT = {
+        S(  87, -77), S(  67, -49), S(   4,  -7), S(  -9, -26),
+        S( -10, -27), S(  -8,  -1), S(  57, -50), S(  79, -82),
+        S(  35,   3), S( -27,  -3), S( -41,  16), S( -89,  29),
+        S( -64,  26), S( -64,  28), S( -25,  -3), S(  30,  -4),
+        S( -44, -19), S( -16, -19), S(  28,   7), S(   0,  35),
+        S(  18,  32), S(  31,   9), S( -13, -18), S( -36, -13),
+        S( -48, -44), S(  98, -39), S(  71,  12), S( -22,  45),
+        S(  12,  41), S(  79,  10), S( 115, -34), S( -59, -38),
+        S(  -6, -10), S(  95, -39), S(  39,  14), S( -49,  18),
+        S( -27,  19), S(  35,  14), S(  81, -34), S( -50, -13),
+        S(  24, -39), S( 123, -22), S( 105,  -1), S( -22, -21),
+        S( -39, -20), S(  74, -15), S( 100, -23), S( -17, -49),
+        S(   0, -98), S(  28, -21), S(   7, -18), S(  -3, -41),
+        S( -57, -39), S(  12, -26), S(  22, -24), S( -15,-119),
+        S( -16,-153), S(  49, -94), S( -21, -73), S( -19, -32),
+        S( -51, -55), S( -42, -62), S(  53, -93), S( -58,-133),
+    },
+
+    /* Pawn Evaluation Terms */
+
+    .PawnCandidatePasser = {
+       {S(   0,   0), S( -11, -18), S( -16,  18), S( -18,  29),
+        S( -22,  61), S(  21,  59), S(   0,   0), S(   0,   0)},
+       {S(   0,   0), S( -12,  21), S(  -7,  27), S(   2,  53),
+        S(  22, 116), S(  49,  78), S(   0,   0), S(   0,   0)},
+    },
+
+    .PawnIsolated = {
+        S( -13, -12), S(  -1, -16), S(   1, -16), S(   3, -18),
+        S(   7, -19), S(   3, -15), S(  -4, -14), S(  -4, -17),
+    },
+
+    .PawnStacked = {
+       {S(  10, -29), S(  -2, -26), S(   0, -23), S(   0, -20),
+        S(   3, -20), S(   5, -26), S(   4, -30), S(   8, -31)},
+       {S(   3, -14), S(   0, -15), S(  -6,  -9), S(  -7, -10),
+        S(  -4,  -9), S(  -2, -10), S(   0, -13), S(   0, -17)},
+    },
+
+    .PawnBackwards = {
+       {S(   0,   0), S(   0,  -7), S(   7,  -7), S(   6, -18),
+        S(  -4, -29), S(   0,   0), S(   0,   0), S(   0,   0)},
+       {S(   0,   0), S(  -9, -32), S(  -5, -30), S(   3, -31),
+        S(  29, -41), S(   0,   0), S(   0,   0), S(   0,   0)},
+    },
+
+    .PawnConnected32 = {
+        S(   0,   0), S(   0,   0), S(   0,   0), S(   0,   0),
+        S(  -1, -11), S(  12,  -4), S(   0,  -2), S(   6,   8),
+        S(  14,   0), S(  20,  -6), S(  19,   3), S(  17,   8),
+        S(   6,  -1), S(  20,   1), S(   6,   3), S(  14,  10),
+        S(   8,  14), S(  21,  17), S(  31,  23), S(  25,  18),
+        S(  45,  40), S(  36,  64), S(  58,  74), S(  64,  88),
+        S( 108,  35), S( 214,  45), S( 216,  70), S( 233,  61),
+        S(   0,   0), S(   0,   0), S(   0,   0), S(   0,   0),
+    },
+
+    /* Knight Evaluation Terms */
+
+    .KnightOutpost = {
+       {S(  12, -32), S(  40,   0)},
+       {S(   7, -24), S(  21,  -3)},
+    },
+
+    .KnightBehindPawn = S(   3,  28),
+
+    .KnightInSiberia = {
+        S(  -9,  -6), S( -12, -20), S( -27, -20), S( -47, -19),
+    },
+
+    .KnightMobility = {
+        S(-104,-139), S( -45,-114), S( -22, -37), S(  -8,   3),
+        S(   6,  15), S(  11,  34), S(  19,  38), S(  30,  37),
+        S(  43,  17),
+    },
+
+    /* Bishop Evaluation Terms */
+
+    .BishopPair = S(  22,  88),
+
+    .BishopRammedPawns = S(  -8, -17),
+
+    .BishopOutpost = {
+       {S(  16, -16), S(  50,  -3)},
+       {S(   9,  -9), S(  -4,  -4)},
+    },
+
+    .BishopBehindPawn = S(   4,  24),
+
+    .BishopLongDiagonal = S(  26,  20),
+
+    .BishopMobility = {
+        S( -99,-186), S( -46,-124), S( -16, -54), S(  -4, -14),
+        S(   6,   1), S(  14,  20), S(  17,  35), S(  19,  39),
+        S(  19,  49), S(  27,  48), S(  26,  48), S(  52,  32),
+        S(  55,  47), S(  83,   2),
+    },
+
+    /* Rook Evaluation Terms */
+
+    .RookFile = { S(  10,   9), S(  34,   8) },
+
+    .RookOnSeventh = S(  -1,  42),
+
+    .RookMobility = {
+        S(-127,-148), S( -56,-127), S( -25, -85), S( -12, -28),
+        S( -10,   2), S( -12,  27), S( -11,  42), S(  -4,  46),
+        S(   4,  52), S(   9,  55), S(  11,  64), S(  19,  68),
+        S(  19,  73), S(  37,  60), S(  97,  15),
+    },
+
+    /* Queen Evaluation Terms */
+
+    .QueenRelativePin = S( -22, -13),
+
+    .QueenMobility = {
+        S(-111,-273), S(-253,-401), S(-127,-228), S( -46,-236),
+        S( -20,-173), S(  -9, -86), S(  -1, -35), S(   2,  -1),
+        S(   8,   8), S(  10,  31), S(  15,  37), S(  17,  55),
+        S(  20,  46), S(  23,  57), S(  22,  58), S(  21,  64),
+        S(  24,  62), S(  16,  65), S(  13,  63), S(  18,  48),
+        S(  25,  30), S(  38,   8), S(  34, -12), S(  28, -29),
+        S(  10, -44), S(   7, -79), S( -42, -30), S( -23, -50),
+    },
+
+    /* King Evaluation Terms */
+
+    .KingDefenders = {
+        S( -37,  -3), S( -17,   2), S(   0,   6), S(  11,   8),
+        S(  21,   8), S(  32,   0), S(  38, -14), S(  10,  -5),
+        S(  12,   6), S(  12,   6), S(  12,   6), S(  12,   6),
+    },
+
+    .KingPawnFileProximity = {
+        S(  36,  46), S(  22,  31), S(  13,  15), S(  -8, -22),
+        S(  -5, -62), S(  -3, -75), S( -15, -81), S( -12, -75),
+    },
+
+    .KingShelter = {
+      {{S(  -5,  -5), S(  17, -31), S(  26,  -3), S(  24,   8),
+        S(   4,   1), S( -12,   4), S( -16, -33), S( -59,  24)},
+       {S(  11,  -6), S(   3, -15), S(  -5,  -2), S(   5,  -4),
+        S( -11,   7), S( -53,  70), S(  81,  82), S( -19,   1)},
+       {S(  38,  -3), S(   5,  -6), S( -34,   5), S( -17, -15),
+        S(  -9,  -5), S( -26,  12), S(  11,  73), S( -16,  -1)},
+       {S(  18,  11), S(  25, -18), S(   0, -14), S(  10, -21),
+        S(  22, -34), S( -48,   9), S(-140,  49), S(  -5,  -5)},
+       {S( -11,  15), S(   1,  -3), S( -44,   6), S( -28,  10),
+        S( -24,  -2), S( -35,  -5), S(  40, -24), S( -13,   3)},
+       {S(  51, -14), S(  15, -14), S( -24,   5), S( -10, -20),
+        S(  10, -34), S(  34, -20), S(  48, -38), S( -21,   1)},
+       {S(  40, -17), S(   2, -24), S( -31,  -1), S( -24,  -8),
+        S( -31,   2), S( -20,  29), S(   4,  49), S( -16,   3)},
+       {S(  10, -20), S(   4, -24), S(  10,   2), S(   2,  16),
+        S( -10,  24), S( -10,  44), S(-184,  81), S( -17,  17)}},
+      {{S(   0,   0), S( -15, -39), S(   9, -29), S( -49,  14),
+        S( -36,   6), S(  -8,  50), S(-168,  -3), S( -59,  19)},
+       {S(   0,   0), S(  17, -18), S(   9, -11), S( -11,  -5),
+        S(  -1, -24), S(  26,  73), S(-186,   4), S( -32,  11)},
+       {S(   0,   0), S(  19,  -9), S(   1, -11), S(   9, -26),
+        S(  28,  -5), S( -92,  56), S( -88, -74), S(  -8,   1)},
+       {S(   0,   0), S(   0,   3), S(  -6,  -6), S( -35,  10),
+        S( -46,  13), S( -98,  33), S(  -7, -45), S( -35,  -5)},
+       {S(   0,   0), S(  12,  -3), S(  17, -15), S(  17, -15),
+        S(  -5, -14), S( -36,   5), S(-101, -52), S( -18,  -1)},
+       {S(   0,   0), S(  -8,  -5), S( -22,   1), S( -16,  -6),
+        S(  25, -22), S( -27,  10), S(  52,  39), S( -14,  -2)},
+       {S(   0,   0), S(  32, -22), S(  19, -15), S(  -9,  -6),
+        S( -29,  13), S(  -7,  23), S( -50, -39), S( -27,  18)},
+       {S(   0,   0), S(  16, -57), S(  17, -32), S( -18,  -7),
+        S( -31,  24), S( -11,  24), S(-225, -49), S( -30,   5)}},
+    },
+
+    .KingStorm = {
+      {{S(  -6,  36), S( 144,  -4), S( -13,  26), S(  -7,   1),
+        S( -12,  -3), S(  -8,  -7), S( -19,   8), S( -28,  -2)},
+       {S( -17,  60), S(  64,  17), S(  -9,  21), S(   8,  12),
+        S(   3,   9), S(   6,  -2), S(  -5,   2), S( -16,   8)},
+       {S(   2,  48), S(  15,  30), S( -17,  20), S( -13,  10),
+        S(  -1,   6), S(   7,   3), S(   8,  -7), S(   7,   8)},
+       {S(  -1,  25), S(  15,  22), S( -31,  10), S( -22,   1),
+        S( -15,   4), S(  13, -10), S(   3,  -5), S( -20,   8)}},
+      {{S(   0,   0), S( -18, -16), S( -18,  -2), S(  27, -24),
+        S(  10,  -6), S(  15, -24), S(  -6,   9), S(   9,  30)},
+       {S(   0,   0), S( -15, -42), S(  -3, -15), S(  53, -17),
+        S(  15,  -5), S(  20, -28), S( -12, -17), S( -34,   5)},
+       {S(   0,   0), S( -34, -62), S( -15, -13), S(   9,  -6),
+        S(   6,  -2), S(  -2, -17), S(  -5, -21), S(  -3,   3)},
+       {S(   0,   0), S(  -1, -26), S( -27, -19), S( -21,   4),
+        S( -10,  -6), S(   7, -35), S(  66, -29), S(  11,  25)}},
+    },
+
+    /* Safety Evaluation Terms */
+
+    .SafetyKnightWeight    = S(  48,  41),
+    .SafetyBishopWeight    = S(  24,  35),
+    .SafetyRookWeight      = S(  36,   8),
+    .SafetyQueenWeight     = S(  30,   6),
+
+    .SafetyAttackValue     = S(  45,  34),
+    .SafetyWeakSquares     = S(  42,  41),
+    .SafetyNoEnemyQueens   = S(-237,-259),
+    .SafetySafeQueenCheck  = S(  93,  83),
+    .SafetySafeRookCheck   = S(  90,  98),
+    .SafetySafeBishopCheck = S(  59,  59),
+    .SafetySafeKnightCheck = S( 112, 117),
+    .SafetyAdjustment      = S( -74, -26),
+
+    .SafetyShelter = {
+       {S(  -2,   7), S(  -1,  13), S(   0,   8), S(   4,   7),
+        S(   6,   2), S(  -1,   0), S(   2,   0), S(   0, -13)},
+       {S(   0,   0), S(  -2,  13), S(  -2,   9), S(   4,   5),
+        S(   3,   1), S(  -3,   0), S(  -2,   0), S(  -1,  -9)},
+    },
+
+    .SafetyStorm = {
+       {S(  -4,  -1), S(  -8,   3), S(   0,   5), S(   1,  -1),
+        S(   3,   6), S(  -2,  20), S(  -2,  18), S(   2, -12)},
+       {S(   0,   0), S(   1,   0), S(  -1,   4), S(   0,   0),
+        S(   0,   5), S(  -1,   1), S(   1,   0), S(   1,   0)},
+    },
+
+    /* Passed Pawn Evaluation Terms */
+
+    .PassedPawn = {
+      {{S(   0,   0), S( -39,  -4), S( -43,  25), S( -62,  28),
+        S(   8,  19), S(  97,  -4), S( 162,  46), S(   0,   0)},
+       {S(   0,   0), S( -28,  13), S( -40,  42), S( -56,  44),
+        S(  -2,  56), S( 114,  54), S( 193,  94), S(   0,   0)}},
+      {{S(   0,   0), S( -28,  29), S( -47,  36), S( -60,  54),
+        S(   8,  65), S( 106,  76), S( 258, 124), S(   0,   0)},
+       {S(   0,   0), S( -28,  23), S( -40,  35), S( -55,  60),
+        S(   8,  89), S(  95, 166), S( 124, 293), S(   0,   0)}},
+    },
+
+    .PassedFriendlyDistance = {
+        S(   0,   0), S(  -3,   1), S(   0,  -4), S(   5, -13),
+        S(   6, -19), S(  -9, -19), S(  -9,  -7), S(   0,   0),
+    },
+
+    .PassedEnemyDistance = {
+        S(   0,   0), S(   5,  -1), S(   7,   0), S(   9,  11),
+        S(   0,  25), S(   1,  37), S(  16,  37), S(   0,   0),
+    },
+
+    .PassedSafePromotionPath = S( -49,  57),
+
+    /* Threat Evaluation Terms */
+
+    .ThreatWeakPawn             = S( -11, -38),
+    .ThreatMinorAttackedByPawn  = S( -55, -83),
+    .ThreatMinorAttackedByMinor = S( -25, -45),
+    .ThreatMinorAttackedByMajor = S( -30, -55),
+    .ThreatRookAttackedByLesser = S( -48, -28),
+    .ThreatMinorAttackedByKing  = S( -43, -21),
+    .ThreatRookAttackedByKing   = S( -33, -18),
+    .ThreatQueenAttackedByOne   = S( -50,  -7),
+    .ThreatOverloadedPieces     = S(  -7, -16),
+    .ThreatByPawnPush           = S(  15,  32),
+
+    /* Space Evaluation Terms */
+
+    .SpaceRestrictPiece = S(  -4,  -1),
+    .SpaceRestrictEmpty = S(  -4,  -2),
+    .SpaceCenterControl = S(   3,   0),
+
+    /* Closedness Evaluation Terms */
+
+    .ClosednessKnightAdjustment = {
+        S(  -7,  10), S(  -7,  29), S(  -9,  37), S(  -5,  37),
+        S(  -3,  44), S(  -1,  36), S(   1,  33), S( -10,  51),
+        S(  -7,  30),
+    },
+
+    .ClosednessRookAdjustment = {
+        S(  42,  43), S(  -6,  80), S(   3,  59), S(  -5,  47),
+        S(  -7,  41), S(  -3,  23), S(  -6,  11), S( -17,  11),
+        S( -34, -12),
+    },
+
+    /* Complexity Evaluation Terms */
+
+    .ComplexityTotalPawns  = S(   0,   8),
+    .ComplexityPawnFlanks  = S(   0,  82),
+    .ComplexityPawnEndgame = S(   0,  76),
+    .ComplexityAdjustment  = S(   0,-157),
 };
 
-const int KnightPSQT[SQUARE_NB] = {
-    S( -31, -38), S(  -6, -24), S( -20, -22), S( -16,  -1),
-    S( -11,  -1), S( -22, -19), S(  -8, -20), S( -41, -30),
-    S(   1,  -5), S( -11,   3), S(  -6, -19), S(  -1,  -2),
-    S(   0,   0), S(  -9, -16), S(  -8,  -3), S(  -6,   1),
-    S(   7, -21), S(   8,  -5), S(   7,   2), S(  10,  19),
-    S(  10,  19), S(   4,   2), S(   8,  -4), S(   3, -19),
-    S(  16,  21), S(  17,  30), S(  23,  41), S(  27,  50),
-    S(  24,  53), S(  23,  41), S(  19,  28), S(  13,  26),
-    S(  13,  30), S(  23,  30), S(  37,  51), S(  30,  70),
-    S(  26,  67), S(  38,  50), S(  22,  33), S(  14,  28),
-    S( -24,  25), S(  -5,  37), S(  25,  56), S(  22,  60),
-    S(  27,  55), S(  29,  55), S(  -1,  32), S( -19,  25),
-    S(  13,  -2), S( -11,  18), S(  27,  -2), S(  37,  24),
-    S(  41,  24), S(  40,  -7), S( -13,  16), S(   2,  -2),
-    S(-167,  -5), S( -91,  12), S(-117,  41), S( -38,  17),
-    S( -18,  19), S(-105,  48), S(-119,  24), S(-165, -17),
-};
-
-const int BishopPSQT[SQUARE_NB] = {
-    S(   5, -21), S(   1,   1), S(  -1,   5), S(   1,   5),
-    S(   2,   8), S(  -6,  -2), S(   0,   1), S(   4, -25),
-    S(  26, -17), S(   2, -31), S(  15,  -2), S(   8,   8),
-    S(   8,   8), S(  13,  -3), S(   9, -31), S(  26, -29),
-    S(   9,   3), S(  22,   9), S(  -5,  -3), S(  18,  19),
-    S(  17,  20), S(  -5,  -6), S(  20,   4), S(  15,   8),
-    S(   0,  12), S(  10,  17), S(  17,  32), S(  20,  32),
-    S(  24,  34), S(  12,  30), S(  15,  17), S(   0,  14),
-    S( -20,  34), S(  13,  31), S(   1,  38), S(  21,  45),
-    S(  12,  46), S(   6,  38), S(  13,  33), S( -14,  37),
-    S( -13,  31), S( -11,  45), S(  -7,  23), S(   2,  40),
-    S(   8,  38), S( -21,  34), S(  -5,  46), S(  -9,  35),
-    S( -59,  38), S( -49,  22), S( -13,  30), S( -35,  36),
-    S( -33,  36), S( -13,  33), S( -68,  21), S( -55,  35),
-    S( -66,  18), S( -65,  36), S(-123,  48), S(-107,  56),
-    S(-112,  53), S( -97,  43), S( -33,  22), S( -74,  15),
-};
-
-const int RookPSQT[SQUARE_NB] = {
-    S( -26,  -1), S( -21,   3), S( -14,   4), S(  -6,  -4),
-    S(  -5,  -4), S( -10,   3), S( -13,  -2), S( -22, -14),
-    S( -70,   5), S( -25, -10), S( -18,  -7), S( -11, -11),
-    S(  -9, -13), S( -15, -15), S( -15, -17), S( -77,   3),
-    S( -39,   3), S( -16,  14), S( -25,   9), S( -14,   2),
-    S( -12,   3), S( -25,   8), S(  -4,   9), S( -39,   1),
-    S( -32,  24), S( -21,  36), S( -21,  36), S(  -5,  26),
-    S(  -8,  27), S( -19,  34), S( -13,  33), S( -30,  24),
-    S( -22,  46), S(   4,  38), S(  16,  38), S(  35,  30),
-    S(  33,  32), S(  10,  36), S(  17,  31), S( -14,  43),
-    S( -33,  60), S(  17,  41), S(   0,  54), S(  33,  36),
-    S(  29,  35), S(   3,  52), S(  33,  32), S( -26,  56),
-    S( -18,  41), S( -24,  47), S(  -1,  38), S(  15,  38),
-    S(  14,  37), S(  -2,  36), S( -24,  49), S( -12,  38),
-    S(  33,  55), S(  24,  63), S(  -1,  73), S(   9,  66),
-    S(  10,  67), S(   0,  69), S(  34,  59), S(  37,  56),
-};
-
-const int QueenPSQT[SQUARE_NB] = {
-    S(  20, -34), S(   4, -26), S(   9, -34), S(  17, -16),
-    S(  18, -18), S(  14, -46), S(   9, -28), S(  22, -44),
-    S(   6, -15), S(  15, -22), S(  22, -42), S(  13,   2),
-    S(  17,   0), S(  22, -49), S(  18, -29), S(   3, -18),
-    S(   6,  -1), S(  21,   7), S(   5,  35), S(   0,  34),
-    S(   2,  34), S(   5,  37), S(  24,   9), S(  13, -15),
-    S(   9,  17), S(  12,  46), S(  -6,  59), S( -19, 109),
-    S( -17, 106), S(  -4,  57), S(  18,  48), S(   8,  33),
-    S( -10,  42), S(  -8,  79), S( -19,  66), S( -32, 121),
-    S( -32, 127), S( -23,  80), S(  -8,  95), S( -10,  68),
-    S( -28,  56), S( -23,  50), S( -33,  66), S( -18,  70),
-    S( -17,  71), S( -19,  63), S( -18,  65), S( -28,  76),
-    S( -16,  61), S( -72, 108), S( -19,  65), S( -52, 114),
-    S( -54, 120), S( -14,  59), S( -69, 116), S( -11,  73),
-    S(   8,  43), S(  19,  47), S(   0,  79), S(   3,  78),
-    S(  -3,  89), S(  13,  65), S(  18,  79), S(  21,  56),
-};
-
-const int KingPSQT[SQUARE_NB] = {
-    S(  87, -77), S(  67, -49), S(   4,  -7), S(  -9, -26),
-    S( -10, -27), S(  -8,  -1), S(  57, -50), S(  79, -82),
-    S(  35,   3), S( -27,  -3), S( -41,  16), S( -89,  29),
-    S( -64,  26), S( -64,  28), S( -25,  -3), S(  30,  -4),
-    S( -44, -19), S( -16, -19), S(  28,   7), S(   0,  35),
-    S(  18,  32), S(  31,   9), S( -13, -18), S( -36, -13),
-    S( -48, -44), S(  98, -39), S(  71,  12), S( -22,  45),
-    S(  12,  41), S(  79,  10), S( 115, -34), S( -59, -38),
-    S(  -6, -10), S(  95, -39), S(  39,  14), S( -49,  18),
-    S( -27,  19), S(  35,  14), S(  81, -34), S( -50, -13),
-    S(  24, -39), S( 123, -22), S( 105,  -1), S( -22, -21),
-    S( -39, -20), S(  74, -15), S( 100, -23), S( -17, -49),
-    S(   0, -98), S(  28, -21), S(   7, -18), S(  -3, -41),
-    S( -57, -39), S(  12, -26), S(  22, -24), S( -15,-119),
-    S( -16,-153), S(  49, -94), S( -21, -73), S( -19, -32),
-    S( -51, -55), S( -42, -62), S(  53, -93), S( -58,-133),
-};
-
-/* Pawn Evaluation Terms */
-
-const int PawnCandidatePasser[2][RANK_NB] = {
-   {S(   0,   0), S( -11, -18), S( -16,  18), S( -18,  29),
-    S( -22,  61), S(  21,  59), S(   0,   0), S(   0,   0)},
-   {S(   0,   0), S( -12,  21), S(  -7,  27), S(   2,  53),
-    S(  22, 116), S(  49,  78), S(   0,   0), S(   0,   0)},
-};
-
-const int PawnIsolated[FILE_NB] = {
-    S( -13, -12), S(  -1, -16), S(   1, -16), S(   3, -18),
-    S(   7, -19), S(   3, -15), S(  -4, -14), S(  -4, -17),
-};
-
-const int PawnStacked[2][FILE_NB] = {
-   {S(  10, -29), S(  -2, -26), S(   0, -23), S(   0, -20),
-    S(   3, -20), S(   5, -26), S(   4, -30), S(   8, -31)},
-   {S(   3, -14), S(   0, -15), S(  -6,  -9), S(  -7, -10),
-    S(  -4,  -9), S(  -2, -10), S(   0, -13), S(   0, -17)},
-};
-
-const int PawnBackwards[2][RANK_NB] = {
-   {S(   0,   0), S(   0,  -7), S(   7,  -7), S(   6, -18),
-    S(  -4, -29), S(   0,   0), S(   0,   0), S(   0,   0)},
-   {S(   0,   0), S(  -9, -32), S(  -5, -30), S(   3, -31),
-    S(  29, -41), S(   0,   0), S(   0,   0), S(   0,   0)},
-};
-
-const int PawnConnected32[32] = {
-    S(   0,   0), S(   0,   0), S(   0,   0), S(   0,   0),
-    S(  -1, -11), S(  12,  -4), S(   0,  -2), S(   6,   8),
-    S(  14,   0), S(  20,  -6), S(  19,   3), S(  17,   8),
-    S(   6,  -1), S(  20,   1), S(   6,   3), S(  14,  10),
-    S(   8,  14), S(  21,  17), S(  31,  23), S(  25,  18),
-    S(  45,  40), S(  36,  64), S(  58,  74), S(  64,  88),
-    S( 108,  35), S( 214,  45), S( 216,  70), S( 233,  61),
-    S(   0,   0), S(   0,   0), S(   0,   0), S(   0,   0),
-};
-
-/* Knight Evaluation Terms */
-
-const int KnightOutpost[2][2] = {
-   {S(  12, -32), S(  40,   0)},
-   {S(   7, -24), S(  21,  -3)},
-};
-
-const int KnightBehindPawn = S(   3,  28);
-
-const int KnightInSiberia[4] = {
-    S(  -9,  -6), S( -12, -20), S( -27, -20), S( -47, -19),
-};
-
-const int KnightMobility[9] = {
-    S(-104,-139), S( -45,-114), S( -22, -37), S(  -8,   3),
-    S(   6,  15), S(  11,  34), S(  19,  38), S(  30,  37),
-    S(  43,  17),
-};
-
-/* Bishop Evaluation Terms */
-
-const int BishopPair = S(  22,  88);
-
-const int BishopRammedPawns = S(  -8, -17);
-
-const int BishopOutpost[2][2] = {
-   {S(  16, -16), S(  50,  -3)},
-   {S(   9,  -9), S(  -4,  -4)},
-};
-
-const int BishopBehindPawn = S(   4,  24);
-
-const int BishopLongDiagonal = S(  26,  20);
-
-const int BishopMobility[14] = {
-    S( -99,-186), S( -46,-124), S( -16, -54), S(  -4, -14),
-    S(   6,   1), S(  14,  20), S(  17,  35), S(  19,  39),
-    S(  19,  49), S(  27,  48), S(  26,  48), S(  52,  32),
-    S(  55,  47), S(  83,   2),
-};
-
-/* Rook Evaluation Terms */
-
-const int RookFile[2] = { S(  10,   9), S(  34,   8) };
-
-const int RookOnSeventh = S(  -1,  42);
-
-const int RookMobility[15] = {
-    S(-127,-148), S( -56,-127), S( -25, -85), S( -12, -28),
-    S( -10,   2), S( -12,  27), S( -11,  42), S(  -4,  46),
-    S(   4,  52), S(   9,  55), S(  11,  64), S(  19,  68),
-    S(  19,  73), S(  37,  60), S(  97,  15),
-};
-
-/* Queen Evaluation Terms */
-
-const int QueenRelativePin = S( -22, -13);
-
-const int QueenMobility[28] = {
-    S(-111,-273), S(-253,-401), S(-127,-228), S( -46,-236),
-    S( -20,-173), S(  -9, -86), S(  -1, -35), S(   2,  -1),
-    S(   8,   8), S(  10,  31), S(  15,  37), S(  17,  55),
-    S(  20,  46), S(  23,  57), S(  22,  58), S(  21,  64),
-    S(  24,  62), S(  16,  65), S(  13,  63), S(  18,  48),
-    S(  25,  30), S(  38,   8), S(  34, -12), S(  28, -29),
-    S(  10, -44), S(   7, -79), S( -42, -30), S( -23, -50),
-};
-
-/* King Evaluation Terms */
-
-const int KingDefenders[12] = {
-    S( -37,  -3), S( -17,   2), S(   0,   6), S(  11,   8),
-    S(  21,   8), S(  32,   0), S(  38, -14), S(  10,  -5),
-    S(  12,   6), S(  12,   6), S(  12,   6), S(  12,   6),
-};
-
-const int KingPawnFileProximity[FILE_NB] = {
-    S(  36,  46), S(  22,  31), S(  13,  15), S(  -8, -22),
-    S(  -5, -62), S(  -3, -75), S( -15, -81), S( -12, -75),
-};
-
-const int KingShelter[2][FILE_NB][RANK_NB] = {
-  {{S(  -5,  -5), S(  17, -31), S(  26,  -3), S(  24,   8),
-    S(   4,   1), S( -12,   4), S( -16, -33), S( -59,  24)},
-   {S(  11,  -6), S(   3, -15), S(  -5,  -2), S(   5,  -4),
-    S( -11,   7), S( -53,  70), S(  81,  82), S( -19,   1)},
-   {S(  38,  -3), S(   5,  -6), S( -34,   5), S( -17, -15),
-    S(  -9,  -5), S( -26,  12), S(  11,  73), S( -16,  -1)},
-   {S(  18,  11), S(  25, -18), S(   0, -14), S(  10, -21),
-    S(  22, -34), S( -48,   9), S(-140,  49), S(  -5,  -5)},
-   {S( -11,  15), S(   1,  -3), S( -44,   6), S( -28,  10),
-    S( -24,  -2), S( -35,  -5), S(  40, -24), S( -13,   3)},
-   {S(  51, -14), S(  15, -14), S( -24,   5), S( -10, -20),
-    S(  10, -34), S(  34, -20), S(  48, -38), S( -21,   1)},
-   {S(  40, -17), S(   2, -24), S( -31,  -1), S( -24,  -8),
-    S( -31,   2), S( -20,  29), S(   4,  49), S( -16,   3)},
-   {S(  10, -20), S(   4, -24), S(  10,   2), S(   2,  16),
-    S( -10,  24), S( -10,  44), S(-184,  81), S( -17,  17)}},
-  {{S(   0,   0), S( -15, -39), S(   9, -29), S( -49,  14),
-    S( -36,   6), S(  -8,  50), S(-168,  -3), S( -59,  19)},
-   {S(   0,   0), S(  17, -18), S(   9, -11), S( -11,  -5),
-    S(  -1, -24), S(  26,  73), S(-186,   4), S( -32,  11)},
-   {S(   0,   0), S(  19,  -9), S(   1, -11), S(   9, -26),
-    S(  28,  -5), S( -92,  56), S( -88, -74), S(  -8,   1)},
-   {S(   0,   0), S(   0,   3), S(  -6,  -6), S( -35,  10),
-    S( -46,  13), S( -98,  33), S(  -7, -45), S( -35,  -5)},
-   {S(   0,   0), S(  12,  -3), S(  17, -15), S(  17, -15),
-    S(  -5, -14), S( -36,   5), S(-101, -52), S( -18,  -1)},
-   {S(   0,   0), S(  -8,  -5), S( -22,   1), S( -16,  -6),
-    S(  25, -22), S( -27,  10), S(  52,  39), S( -14,  -2)},
-   {S(   0,   0), S(  32, -22), S(  19, -15), S(  -9,  -6),
-    S( -29,  13), S(  -7,  23), S( -50, -39), S( -27,  18)},
-   {S(   0,   0), S(  16, -57), S(  17, -32), S( -18,  -7),
-    S( -31,  24), S( -11,  24), S(-225, -49), S( -30,   5)}},
-};
-
-const int KingStorm[2][FILE_NB/2][RANK_NB] = {
-  {{S(  -6,  36), S( 144,  -4), S( -13,  26), S(  -7,   1),
-    S( -12,  -3), S(  -8,  -7), S( -19,   8), S( -28,  -2)},
-   {S( -17,  60), S(  64,  17), S(  -9,  21), S(   8,  12),
-    S(   3,   9), S(   6,  -2), S(  -5,   2), S( -16,   8)},
-   {S(   2,  48), S(  15,  30), S( -17,  20), S( -13,  10),
-    S(  -1,   6), S(   7,   3), S(   8,  -7), S(   7,   8)},
-   {S(  -1,  25), S(  15,  22), S( -31,  10), S( -22,   1),
-    S( -15,   4), S(  13, -10), S(   3,  -5), S( -20,   8)}},
-  {{S(   0,   0), S( -18, -16), S( -18,  -2), S(  27, -24),
-    S(  10,  -6), S(  15, -24), S(  -6,   9), S(   9,  30)},
-   {S(   0,   0), S( -15, -42), S(  -3, -15), S(  53, -17),
-    S(  15,  -5), S(  20, -28), S( -12, -17), S( -34,   5)},
-   {S(   0,   0), S( -34, -62), S( -15, -13), S(   9,  -6),
-    S(   6,  -2), S(  -2, -17), S(  -5, -21), S(  -3,   3)},
-   {S(   0,   0), S(  -1, -26), S( -27, -19), S( -21,   4),
-    S( -10,  -6), S(   7, -35), S(  66, -29), S(  11,  25)}},
-};
-
-/* Safety Evaluation Terms */
-
-const int SafetyKnightWeight    = S(  48,  41);
-const int SafetyBishopWeight    = S(  24,  35);
-const int SafetyRookWeight      = S(  36,   8);
-const int SafetyQueenWeight     = S(  30,   6);
-
-const int SafetyAttackValue     = S(  45,  34);
-const int SafetyWeakSquares     = S(  42,  41);
-const int SafetyNoEnemyQueens   = S(-237,-259);
-const int SafetySafeQueenCheck  = S(  93,  83);
-const int SafetySafeRookCheck   = S(  90,  98);
-const int SafetySafeBishopCheck = S(  59,  59);
-const int SafetySafeKnightCheck = S( 112, 117);
-const int SafetyAdjustment      = S( -74, -26);
-
-const int SafetyShelter[2][RANK_NB] = {
-   {S(  -2,   7), S(  -1,  13), S(   0,   8), S(   4,   7),
-    S(   6,   2), S(  -1,   0), S(   2,   0), S(   0, -13)},
-   {S(   0,   0), S(  -2,  13), S(  -2,   9), S(   4,   5),
-    S(   3,   1), S(  -3,   0), S(  -2,   0), S(  -1,  -9)},
-};
-
-const int SafetyStorm[2][RANK_NB] = {
-   {S(  -4,  -1), S(  -8,   3), S(   0,   5), S(   1,  -1),
-    S(   3,   6), S(  -2,  20), S(  -2,  18), S(   2, -12)},
-   {S(   0,   0), S(   1,   0), S(  -1,   4), S(   0,   0),
-    S(   0,   5), S(  -1,   1), S(   1,   0), S(   1,   0)},
-};
-
-/* Passed Pawn Evaluation Terms */
-
-const int PassedPawn[2][2][RANK_NB] = {
-  {{S(   0,   0), S( -39,  -4), S( -43,  25), S( -62,  28),
-    S(   8,  19), S(  97,  -4), S( 162,  46), S(   0,   0)},
-   {S(   0,   0), S( -28,  13), S( -40,  42), S( -56,  44),
-    S(  -2,  56), S( 114,  54), S( 193,  94), S(   0,   0)}},
-  {{S(   0,   0), S( -28,  29), S( -47,  36), S( -60,  54),
-    S(   8,  65), S( 106,  76), S( 258, 124), S(   0,   0)},
-   {S(   0,   0), S( -28,  23), S( -40,  35), S( -55,  60),
-    S(   8,  89), S(  95, 166), S( 124, 293), S(   0,   0)}},
-};
-
-const int PassedFriendlyDistance[FILE_NB] = {
-    S(   0,   0), S(  -3,   1), S(   0,  -4), S(   5, -13),
-    S(   6, -19), S(  -9, -19), S(  -9,  -7), S(   0,   0),
-};
-
-const int PassedEnemyDistance[FILE_NB] = {
-    S(   0,   0), S(   5,  -1), S(   7,   0), S(   9,  11),
-    S(   0,  25), S(   1,  37), S(  16,  37), S(   0,   0),
-};
-
-const int PassedSafePromotionPath = S( -49,  57);
-
-/* Threat Evaluation Terms */
-
-const int ThreatWeakPawn             = S( -11, -38);
-const int ThreatMinorAttackedByPawn  = S( -55, -83);
-const int ThreatMinorAttackedByMinor = S( -25, -45);
-const int ThreatMinorAttackedByMajor = S( -30, -55);
-const int ThreatRookAttackedByLesser = S( -48, -28);
-const int ThreatMinorAttackedByKing  = S( -43, -21);
-const int ThreatRookAttackedByKing   = S( -33, -18);
-const int ThreatQueenAttackedByOne   = S( -50,  -7);
-const int ThreatOverloadedPieces     = S(  -7, -16);
-const int ThreatByPawnPush           = S(  15,  32);
-
-/* Space Evaluation Terms */
-
-const int SpaceRestrictPiece = S(  -4,  -1);
-const int SpaceRestrictEmpty = S(  -4,  -2);
-const int SpaceCenterControl = S(   3,   0);
-
-/* Closedness Evaluation Terms */
-
-const int ClosednessKnightAdjustment[9] = {
-    S(  -7,  10), S(  -7,  29), S(  -9,  37), S(  -5,  37),
-    S(  -3,  44), S(  -1,  36), S(   1,  33), S( -10,  51),
-    S(  -7,  30),
-};
-
-const int ClosednessRookAdjustment[9] = {
-    S(  42,  43), S(  -6,  80), S(   3,  59), S(  -5,  47),
-    S(  -7,  41), S(  -3,  23), S(  -6,  11), S( -17,  11),
-    S( -34, -12),
-};
-
-/* Complexity Evaluation Terms */
-
-const int ComplexityTotalPawns  = S(   0,   8);
-const int ComplexityPawnFlanks  = S(   0,  82);
-const int ComplexityPawnEndgame = S(   0,  76);
-const int ComplexityAdjustment  = S(   0,-157);
-
 /* General Evaluation Terms */
 
 const int Tempo = 20;
+const int LazyMargin = 500;
 
 #undef S
 
@@ -451,6 +461,14 @@ int evaluateBoard(Thread *thread, Board *board) {
     if (!TRACE && getCachedEvaluation(thread, board, &hashed))
         return hashed;
 
+    // The NNUE scores from the side to move's POV, and replaces
+    // the entire hand crafted evaluation when it is enabled
+    if (!TRACE && nnueEnabled()) {
+        eval = board->turn == WHITE ? evaluateNNUE(board) : -evaluateNNUE(board);
+        storeCachedEvaluation(thread, board, eval);
+        return Tempo + (board->turn == WHITE ? eval : -eval);
+    }
+
     initEvalInfo(thread, board, &ei);
     eval = evaluatePieces(&ei, board);
 
@@ -459,19 +477,16 @@ int evaluateBoard(Thread *thread, Board *board) {
         pkeval += computePKNetwork(board);
 
     eval += pkeval + board->psqtmat + thread->contempt;
-    eval += evaluateEndgames(board);
+    eval += evaluateEndgames(board, ei.material->egtype);
     eval += evaluateClosedness(&ei, board);
     eval += evaluateComplexity(&ei, board, eval);
 
-    // Calculate the game phase based on remaining material (Fruit Method)
-    phase = 24 - 4 * popcount(board->pieces[QUEEN ])
-               - 2 * popcount(board->pieces[ROOK  ])
-               - 1 * popcount(board->pieces[KNIGHT]
-                             |board->pieces[BISHOP]);
-    phase = (phase * 256 + 12) / 24;
-
-    // Scale evaluation based on remaining material
-    factor = evaluateScaleFactor(board, eval);
+    phase = ei.material->phase;
+
+    // Scale evaluation based on remaining material, after checking for
+    // 3-man and KRKP positions known to be drawn, which the table cannot
+    factor = bitbasesProbe(board) == BITBASE_DRAW ? SCALE_DRAW
+           : ei.material->scale[ScoreEG(eval) < 0 ? BLACK : WHITE];
     if (TRACE) T.factor = factor;
 
     // Compute and store an interpolated evaluation from white's POV
@@ -488,6 +503,46 @@ int evaluateBoard(Thread *thread, Board *board) {
     return Tempo + (board->turn == WHITE ? eval : -eval);
 }
 
+int evaluateBoardLazy(Thread *thread, Board *board, int alpha, int beta) {
+
+    PKEntry *pkentry;
+    int phase, eval, hashed;
+
+    // Defer to the full evaluation whenever the cheap terms are not
+    // available, or when we are tracing or scoring with the NNUE
+    if (   TRACE || nnueEnabled()
+        || thread->moveStack[thread->height-1] == NULL_MOVE
+        || (pkentry = getCachedPawnKingEval(thread, board)) == NULL)
+        return evaluateBoard(thread, board);
+
+    // A full evaluation is always preferred when we have one
+    if (getCachedEvaluation(thread, board, &hashed))
+        return hashed;
+
+    // Material, PSQTs, and the cached Pawn King terms only
+    eval = board->psqtmat + pkentry->eval + thread->contempt;
+    phase = getMaterialEntry(thread, board)->phase;
+    eval = (ScoreMG(eval) * (256 - phase) + ScoreEG(eval) * phase) / 256;
+    eval = Tempo + (board->turn == WHITE ? eval : -eval);
+
+    // Only return the estimate when the remaining terms are very unlikely
+    // to bring it back inside the window. The estimate is never cached
+    if (eval - LazyMargin >= beta || eval + LazyMargin <= alpha)
+        return eval;
+
+    return evaluateBoard(thread, board);
+}
+
+int evaluatePhase(Board *board) {
+
+    // Calculate the game phase based on remaining material (Fruit Method)
+    int phase = 24 - 4 * popcount(board->pieces[QUEEN ])
+                   - 2 * popcount(board->pieces[ROOK  ])
+                   - 1 * popcount(board->pieces[KNIGHT]
+                                 |board->pieces[BISHOP]);
+    return (phase * 256 + 12) / 24;
+}
+
 int evaluatePieces(EvalInfo *ei, Board *board) {
 
     int eval;
@@ -504,6 +559,15 @@ int evaluatePieces(EvalInfo *ei, Board *board) {
     eval +=  evaluateQueens(ei, board, WHITE)  - evaluateQueens(ei, board, BLACK);
     eval +=   evaluateKings(ei, board, WHITE)   - evaluateKings(ei, board, BLACK);
     eval +=  evaluatePassed(ei, board, WHITE)  - evaluatePassed(ei, board, BLACK);
+
+#if defined(USE_PAIRS)
+    if (PAIRS_AVAILABLE) {
+        eval += evaluateThreatsPaired(ei, board);
+        eval +=   evaluateSpacePaired(ei, board);
+        return eval;
+    }
+#endif
+
     eval += evaluateThreats(ei, board, WHITE) - evaluateThreats(ei, board, BLACK);
     eval +=   evaluateSpace(ei, board, WHITE) -   evaluateSpace(ei, board, BLACK);
 
@@ -558,7 +622,7 @@ int evaluatePawns(EvalInfo *ei, Board *board, int colour) {
         // square then exchanging our supporters with the remaining stoppers
         else if (!leftovers && popcount(pushSupport) >= popcount(pushThreats)) {
             flag = popcount(support) >= popcount(threats);
-            pkeval += PawnCandidatePasser[flag][relativeRankOf(US, sq)];
+            pkeval += Params.PawnCandidatePasser[flag][relativeRankOf(US, sq)];
             if (TRACE) T.PawnCandidatePasser[flag][relativeRankOf(US, sq)][US]++;
         }
 
@@ -566,7 +630,7 @@ int evaluatePawns(EvalInfo *ei, Board *board, int colour) {
         // are able to capture another pawn to not be isolated, as they may
         // have the potential to deisolate by capturing, or be traded away
         if (!threats && !neighbors) {
-            pkeval += PawnIsolated[fileOf(sq)];
+            pkeval += Params.PawnIsolated[fileOf(sq)];
             if (TRACE) T.PawnIsolated[fileOf(sq)][US]++;
         }
 
@@ -577,7 +641,7 @@ int evaluatePawns(EvalInfo *ei, Board *board, int colour) {
         if (several(Files[fileOf(sq)] & myPawns)) {
             flag = (stoppers && (threats || neighbors))
                 || (stoppers & ~forwardFileMasks(US, sq));
-            pkeval += PawnStacked[flag][fileOf(sq)];
+            pkeval += Params.PawnStacked[flag][fileOf(sq)];
             if (TRACE) T.PawnStacked[flag][fileOf(sq)][US]++;
         }
 
@@ -586,14 +650,14 @@ int evaluatePawns(EvalInfo *ei, Board *board, int colour) {
         // backwards at the same time. We don't give backward pawns a connected bonus
         if (neighbors && pushThreats && !backup) {
             flag = !(Files[fileOf(sq)] & enemyPawns);
-            pkeval += PawnBackwards[flag][relativeRankOf(US, sq)];
+            pkeval += Params.PawnBackwards[flag][relativeRankOf(US, sq)];
             if (TRACE) T.PawnBackwards[flag][relativeRankOf(US, sq)][US]++;
         }
 
         // Apply a bonus if the pawn is connected and not backwards. We consider a
         // pawn to be connected when there is a pawn lever or the pawn is supported
         else if (pawnConnectedMasks(US, sq) & myPawns) {
-            pkeval += PawnConnected32[relativeSquare32(US, sq)];
+            pkeval += Params.PawnConnected32[relativeSquare32(US, sq)];
             if (TRACE) T.PawnConnected32[relativeSquare32(US, sq)][US]++;
         }
     }
@@ -635,33 +699,33 @@ int evaluateKnights(EvalInfo *ei, Board *board, int colour) {
             && !(outpostSquareMasks(US, sq) & enemyPawns)) {
             outside  = testBit(FILE_A | FILE_H, sq);
             defended = testBit(ei->pawnAttacks[US], sq);
-            eval += KnightOutpost[outside][defended];
+            eval += Params.KnightOutpost[outside][defended];
             if (TRACE) T.KnightOutpost[outside][defended][US]++;
         }
 
         // Apply a bonus if the knight is behind a pawn
         if (testBit(pawnAdvance(board->pieces[PAWN], 0ull, THEM), sq)) {
-            eval += KnightBehindPawn;
+            eval += Params.KnightBehindPawn;
             if (TRACE) T.KnightBehindPawn[US]++;
         }
 
         // Apply a penalty if the knight is far from both kings
         kingDistance = MIN(distanceBetween(sq, ei->kingSquare[THEM]), distanceBetween(sq, ei->kingSquare[US]));
         if (kingDistance >= 4) {
-            eval += KnightInSiberia[kingDistance - 4];
+            eval += Params.KnightInSiberia[kingDistance - 4];
             if (TRACE) T.KnightInSiberia[kingDistance - 4][US]++;
         }
 
         // Apply a bonus (or penalty) based on the mobility of the knight
         count = popcount(ei->mobilityAreas[US] & attacks);
-        eval += KnightMobility[count];
+        eval += Params.KnightMobility[count];
         if (TRACE) T.KnightMobility[count][US]++;
 
         // Update King Safety calculations
         if ((attacks &= ei->kingAreas[THEM] & ~ei->pawnAttacksBy2[THEM])) {
             ei->kingAttacksCount[THEM] += popcount(attacks);
             ei->kingAttackersCount[THEM] += 1;
-            ei->kingAttackersWeight[THEM] += SafetyKnightWeight;
+            ei->kingAttackersWeight[THEM] += Params.SafetyKnightWeight;
             if (TRACE) T.SafetyKnightWeight[THEM]++;
         }
     }
@@ -683,7 +747,7 @@ int evaluateBishops(EvalInfo *ei, Board *board, int colour) {
 
     // Apply a bonus for having a pair of bishops
     if ((tempBishops & WHITE_SQUARES) && (tempBishops & BLACK_SQUARES)) {
-        eval += BishopPair;
+        eval += Params.BishopPair;
         if (TRACE) T.BishopPair[US]++;
     }
 
@@ -704,7 +768,7 @@ int evaluateBishops(EvalInfo *ei, Board *board, int colour) {
         // Apply a penalty for the bishop based on number of rammed pawns
         // of our own colour, which reside on the same shade of square as the bishop
         count = popcount(ei->rammedPawns[US] & squaresOfMatchingColour(sq));
-        eval += count * BishopRammedPawns;
+        eval += count * Params.BishopRammedPawns;
         if (TRACE) T.BishopRammedPawns[US] += count;
 
         // Apply a bonus if the bishop is on an outpost square, and cannot be attacked
@@ -713,33 +777,33 @@ int evaluateBishops(EvalInfo *ei, Board *board, int colour) {
             && !(outpostSquareMasks(US, sq) & enemyPawns)) {
             outside  = testBit(FILE_A | FILE_H, sq);
             defended = testBit(ei->pawnAttacks[US], sq);
-            eval += BishopOutpost[outside][defended];
+            eval += Params.BishopOutpost[outside][defended];
             if (TRACE) T.BishopOutpost[outside][defended][US]++;
         }
 
         // Apply a bonus if the bishop is behind a pawn
         if (testBit(pawnAdvance(board->pieces[PAWN], 0ull, THEM), sq)) {
-            eval += BishopBehindPawn;
+            eval += Params.BishopBehindPawn;
             if (TRACE) T.BishopBehindPawn[US]++;
         }
 
         // Apply a bonus when controlling both central squares on a long diagonal
         if (   testBit(LONG_DIAGONALS & ~CENTER_SQUARES, sq)
             && several(bishopAttacks(sq, board->pieces[PAWN]) & CENTER_SQUARES)) {
-            eval += BishopLongDiagonal;
+            eval += Params.BishopLongDiagonal;
             if (TRACE) T.BishopLongDiagonal[US]++;
         }
 
         // Apply a bonus (or penalty) based on the mobility of the bishop
         count = popcount(ei->mobilityAreas[US] & attacks);
-        eval += BishopMobility[count];
+        eval += Params.BishopMobility[count];
         if (TRACE) T.BishopMobility[count][US]++;
 
         // Update King Safety calculations
         if ((attacks &= ei->kingAreas[THEM] & ~ei->pawnAttacksBy2[THEM])) {
             ei->kingAttacksCount[THEM] += popcount(attacks);
             ei->kingAttackersCount[THEM] += 1;
-            ei->kingAttackersWeight[THEM] += SafetyBishopWeight;
+            ei->kingAttackersWeight[THEM] += Params.SafetyBishopWeight;
             if (TRACE) T.SafetyBishopWeight[THEM]++;
         }
     }
@@ -778,7 +842,7 @@ int evaluateRooks(EvalInfo *ei, Board *board, int colour) {
         // colour on the file. If there are no pawns at all, it is an open file
         if (!(myPawns & Files[fileOf(sq)])) {
             open = !(enemyPawns & Files[fileOf(sq)]);
-            eval += RookFile[open];
+            eval += Params.RookFile[open];
             if (TRACE) T.RookFile[open][US]++;
         }
 
@@ -786,20 +850,20 @@ int evaluateRooks(EvalInfo *ei, Board *board, int colour) {
         // colour so long as the enemy king is on the last two ranks of the board
         if (   relativeRankOf(US, sq) == 6
             && relativeRankOf(US, ei->kingSquare[THEM]) >= 6) {
-            eval += RookOnSeventh;
+            eval += Params.RookOnSeventh;
             if (TRACE) T.RookOnSeventh[US]++;
         }
 
         // Apply a bonus (or penalty) based on the mobility of the rook
         count = popcount(ei->mobilityAreas[US] & attacks);
-        eval += RookMobility[count];
+        eval += Params.RookMobility[count];
         if (TRACE) T.RookMobility[count][US]++;
 
         // Update King Safety calculations
         if ((attacks &= ei->kingAreas[THEM] & ~ei->pawnAttacksBy2[THEM])) {
             ei->kingAttacksCount[THEM] += popcount(attacks);
             ei->kingAttackersCount[THEM] += 1;
-            ei->kingAttackersWeight[THEM] += SafetyRookWeight;
+            ei->kingAttackersWeight[THEM] += Params.SafetyRookWeight;
             if (TRACE) T.SafetyRookWeight[THEM]++;
         }
     }
@@ -835,20 +899,20 @@ int evaluateQueens(EvalInfo *ei, Board *board, int colour) {
 
         // Apply a penalty if the Queen is at risk for a discovered attack
         if (discoveredAttacks(board, sq, US)) {
-            eval += QueenRelativePin;
+            eval += Params.QueenRelativePin;
             if (TRACE) T.QueenRelativePin[US]++;
         }
 
         // Apply a bonus (or penalty) based on the mobility of the queen
         count = popcount(ei->mobilityAreas[US] & attacks);
-        eval += QueenMobility[count];
+        eval += Params.QueenMobility[count];
         if (TRACE) T.QueenMobility[count][US]++;
 
         // Update King Safety calculations
         if ((attacks &= ei->kingAreas[THEM] & ~ei->pawnAttacksBy2[THEM])) {
             ei->kingAttacksCount[THEM] += popcount(attacks);
             ei->kingAttackersCount[THEM] += 1;
-            ei->kingAttackersWeight[THEM] += SafetyQueenWeight;
+            ei->kingAttackersWeight[THEM] += Params.SafetyQueenWeight;
             if (TRACE) T.SafetyQueenWeight[THEM]++;
         }
     }
@@ -873,7 +937,7 @@ int evaluateKingsPawns(EvalInfo *ei, Board *board, int colour) {
     // file-wise pawn. If there is no pawn, kingPawnFileDistance() returns the
     // same distance for both sides causing this evaluation term to be neutral
     dist = kingPawnFileDistance(board->pieces[PAWN], kingSq);
-    ei->pkeval[US] += KingPawnFileProximity[dist];
+    ei->pkeval[US] += Params.KingPawnFileProximity[dist];
     if (TRACE) T.KingPawnFileProximity[dist][US]++;
 
     // Evaluate King Shelter & King Storm threat by looking at the file of our King,
@@ -891,21 +955,21 @@ int evaluateKingsPawns(EvalInfo *ei, Board *board, int colour) {
 
         // Evaluate King Shelter using pawn distance. Use separate evaluation
         // depending on the file, and if we are looking at the King's file
-        ei->pkeval[US] += KingShelter[file == fileOf(kingSq)][file][ourDist];
+        ei->pkeval[US] += Params.KingShelter[file == fileOf(kingSq)][file][ourDist];
         if (TRACE) T.KingShelter[file == fileOf(kingSq)][file][ourDist][US]++;
 
         // Update the Shelter Safety
-        ei->pksafety[US] += SafetyShelter[file == fileOf(kingSq)][ourDist];
+        ei->pksafety[US] += Params.SafetyShelter[file == fileOf(kingSq)][ourDist];
         if (TRACE) T.SafetyShelter[file == fileOf(kingSq)][ourDist][US]++;
 
         // Evaluate King Storm using enemy pawn distance. Use a separate evaluation
         // depending on the file, and if the opponent's pawn is blocked by our own
         blocked = (ourDist != 7 && (ourDist == theirDist - 1));
-        ei->pkeval[US] += KingStorm[blocked][mirrorFile(file)][theirDist];
+        ei->pkeval[US] += Params.KingStorm[blocked][mirrorFile(file)][theirDist];
         if (TRACE) T.KingStorm[blocked][mirrorFile(file)][theirDist][US]++;
 
         // Update the Storm Safety
-        ei->pksafety[US] += SafetyStorm[blocked][theirDist];
+        ei->pksafety[US] += Params.SafetyStorm[blocked][theirDist];
         if (TRACE) T.SafetyStorm[blocked][theirDist][US]++;
     }
 
@@ -930,7 +994,7 @@ int evaluateKings(EvalInfo *ei, Board *board, int colour) {
 
     // Bonus for our pawns and minors sitting within our king area
     count = popcount(defenders & ei->kingAreas[US]);
-    eval += KingDefenders[count];
+    eval += Params.KingDefenders[count];
     if (TRACE) T.KingDefenders[count][US]++;
 
     // Perform King Safety when we have two attackers, or
@@ -968,15 +1032,15 @@ int evaluateKings(EvalInfo *ei, Board *board, int colour) {
 
         safety  = ei->kingAttackersWeight[US];
 
-        safety += SafetyAttackValue     * scaledAttackCounts
-                + SafetyWeakSquares     * popcount(weak & ei->kingAreas[US])
-                + SafetyNoEnemyQueens   * !enemyQueens
-                + SafetySafeQueenCheck  * popcount(queenChecks)
-                + SafetySafeRookCheck   * popcount(rookChecks)
-                + SafetySafeBishopCheck * popcount(bishopChecks)
-                + SafetySafeKnightCheck * popcount(knightChecks)
+        safety += Params.SafetyAttackValue     * scaledAttackCounts
+                + Params.SafetyWeakSquares     * popcount(weak & ei->kingAreas[US])
+                + Params.SafetyNoEnemyQueens   * !enemyQueens
+                + Params.SafetySafeQueenCheck  * popcount(queenChecks)
+                + Params.SafetySafeRookCheck   * popcount(rookChecks)
+                + Params.SafetySafeBishopCheck * popcount(bishopChecks)
+                + Params.SafetySafeKnightCheck * popcount(knightChecks)
                 + ei->pksafety[US]
-                + SafetyAdjustment;
+                + Params.SafetyAdjustment;
 
         if (TRACE) T.SafetyAttackValue[US]     = scaledAttackCounts;
         if (TRACE) T.SafetyWeakSquares[US]     = popcount(weak & ei->kingAreas[US]);
@@ -1032,7 +1096,7 @@ int evaluatePassed(EvalInfo *ei, Board *board, int colour) {
         // Evaluate based on rank, ability to advance, and safety
         canAdvance = !(bitboard & occupied);
         safeAdvance = !(bitboard & ei->attacked[THEM]);
-        eval += PassedPawn[canAdvance][safeAdvance][rank];
+        eval += Params.PassedPawn[canAdvance][safeAdvance][rank];
         if (TRACE) T.PassedPawn[canAdvance][safeAdvance][rank][US]++;
 
         // Short-circuit evaluation for additional passers on a file
@@ -1040,18 +1104,18 @@ int evaluatePassed(EvalInfo *ei, Board *board, int colour) {
 
         // Evaluate based on distance from our king
         dist = distanceBetween(sq, ei->kingSquare[US]);
-        eval += dist * PassedFriendlyDistance[rank];
+        eval += dist * Params.PassedFriendlyDistance[rank];
         if (TRACE) T.PassedFriendlyDistance[rank][US] += dist;
 
         // Evaluate based on distance from their king
         dist = distanceBetween(sq, ei->kingSquare[THEM]);
-        eval += dist * PassedEnemyDistance[rank];
+        eval += dist * Params.PassedEnemyDistance[rank];
         if (TRACE) T.PassedEnemyDistance[rank][US] += dist;
 
         // Apply a bonus when the path to promoting is uncontested
         bitboard = forwardRanksMasks(US, rankOf(sq)) & Files[fileOf(sq)];
         flag = !(bitboard & (board->colours[THEM] | ei->attacked[THEM]));
-        eval += flag * PassedSafePromotionPath;
+        eval += flag * Params.PassedSafePromotionPath;
         if (TRACE) T.PassedSafePromotionPath[US] += flag;
     }
 
@@ -1100,52 +1164,52 @@ int evaluateThreats(EvalInfo *ei, Board *board, int colour) {
 
     // Penalty for each of our poorly supported pawns
     count = popcount(pawns & ~attacksByPawns & poorlyDefended);
-    eval += count * ThreatWeakPawn;
+    eval += count * Params.ThreatWeakPawn;
     if (TRACE) T.ThreatWeakPawn[US] += count;
 
     // Penalty for pawn threats against our minors
     count = popcount((knights | bishops) & attacksByPawns);
-    eval += count * ThreatMinorAttackedByPawn;
+    eval += count * Params.ThreatMinorAttackedByPawn;
     if (TRACE) T.ThreatMinorAttackedByPawn[US] += count;
 
     // Penalty for any minor threat against minor pieces
     count = popcount((knights | bishops) & attacksByMinors);
-    eval += count * ThreatMinorAttackedByMinor;
+    eval += count * Params.ThreatMinorAttackedByMinor;
     if (TRACE) T.ThreatMinorAttackedByMinor[US] += count;
 
     // Penalty for all major threats against poorly supported minors
     count = popcount(weakMinors & attacksByMajors);
-    eval += count * ThreatMinorAttackedByMajor;
+    eval += count * Params.ThreatMinorAttackedByMajor;
     if (TRACE) T.ThreatMinorAttackedByMajor[US] += count;
 
     // Penalty for pawn and minor threats against our rooks
     count = popcount(rooks & (attacksByPawns | attacksByMinors));
-    eval += count * ThreatRookAttackedByLesser;
+    eval += count * Params.ThreatRookAttackedByLesser;
     if (TRACE) T.ThreatRookAttackedByLesser[US] += count;
 
     // Penalty for king threats against our poorly defended minors
     count = popcount(weakMinors & ei->attackedBy[THEM][KING]);
-    eval += count * ThreatMinorAttackedByKing;
+    eval += count * Params.ThreatMinorAttackedByKing;
     if (TRACE) T.ThreatMinorAttackedByKing[US] += count;
 
     // Penalty for king threats against our poorly defended rooks
     count = popcount(rooks & poorlyDefended & ei->attackedBy[THEM][KING]);
-    eval += count * ThreatRookAttackedByKing;
+    eval += count * Params.ThreatRookAttackedByKing;
     if (TRACE) T.ThreatRookAttackedByKing[US] += count;
 
     // Penalty for any threat against our queens
     count = popcount(queens & ei->attacked[THEM]);
-    eval += count * ThreatQueenAttackedByOne;
+    eval += count * Params.ThreatQueenAttackedByOne;
     if (TRACE) T.ThreatQueenAttackedByOne[US] += count;
 
     // Penalty for any overloaded minors or majors
     count = popcount(overloaded);
-    eval += count * ThreatOverloadedPieces;
+    eval += count * Params.ThreatOverloadedPieces;
     if (TRACE) T.ThreatOverloadedPieces[US] += count;
 
     // Bonus for giving threats by safe pawn pushes
     count = popcount(pushThreat);
-    eval += count * ThreatByPawnPush;
+    eval += count * Params.ThreatByPawnPush;
     if (TRACE) T.ThreatByPawnPush[colour] += count;
 
     return eval;
@@ -1166,11 +1230,11 @@ int evaluateSpace(EvalInfo *ei, Board *board, int colour) {
 
     // Penalty for restricted piece moves
     count = popcount(uncontrolled & (friendly | enemy));
-    eval += count * SpaceRestrictPiece;
+    eval += count * Params.SpaceRestrictPiece;
     if (TRACE) T.SpaceRestrictPiece[US] += count;
 
     count = popcount(uncontrolled & ~friendly & ~enemy);
-    eval += count * SpaceRestrictEmpty;
+    eval += count * Params.SpaceRestrictEmpty;
     if (TRACE) T.SpaceRestrictEmpty[US] += count;
 
     // Bonus for uncontested central squares
@@ -1180,22 +1244,178 @@ int evaluateSpace(EvalInfo *ei, Board *board, int colour) {
     if (      popcount(board->pieces[KNIGHT] | board->pieces[BISHOP])
         + 2 * popcount(board->pieces[ROOK  ] | board->pieces[QUEEN ]) > 12) {
         count = popcount(~ei->attacked[THEM] & (ei->attacked[US] | friendly) & CENTER_BIG);
-        eval += count * SpaceCenterControl;
+        eval += count * Params.SpaceCenterControl;
         if (TRACE) T.SpaceCenterControl[US] += count;
     }
 
     return eval;
 }
 
-int evaluateClosedness(EvalInfo *ei, Board *board) {
+#if defined(USE_PAIRS)
 
-    int closedness, count, eval = 0;
+#if defined(USE_DISPATCH)
+    #pragma GCC push_options
+    #pragma GCC target("avx512f,avx512vl,avx512dq,avx512vpopcntdq")
+#endif
 
-    uint64_t white = board->colours[WHITE];
-    uint64_t black = board->colours[BLACK];
+static void tracePair(int trace[COLOUR_NB], BitboardPair count) {
+    trace[WHITE] += count[WHITE];
+    trace[BLACK] += count[BLACK];
+}
 
-    uint64_t knights = board->pieces[KNIGHT];
-    uint64_t rooks   = board->pieces[ROOK  ];
+int evaluateThreatsPaired(EvalInfo *ei, Board *board) {
+
+    // Both colours are evaluated at once. Each BitboardPair is given from the
+    // perspective of the side in that lane, with pairSwap() giving the enemy's
+
+    BitboardPair count, eval = { 0, 0 };
+
+    BitboardPair friendly = pairLoad(board->colours);
+    BitboardPair enemy    = pairSwap(friendly);
+    BitboardPair occupied = friendly | enemy;
+
+    BitboardPair pawns   = friendly & pairOf(board->pieces[PAWN  ]);
+    BitboardPair minors  = friendly & pairOf(board->pieces[KNIGHT] | board->pieces[BISHOP]);
+    BitboardPair rooks   = friendly & pairOf(board->pieces[ROOK  ]);
+    BitboardPair queens  = friendly & pairOf(board->pieces[QUEEN ]);
+
+    BitboardPair attacked    = pairLoad(ei->attacked);
+    BitboardPair attackedBy2 = pairLoad(ei->attackedBy2);
+    BitboardPair attacksOfPawns = pairFrom(ei->attackedBy[WHITE][PAWN], ei->attackedBy[BLACK][PAWN]);
+
+    BitboardPair enemyAttacked    = pairSwap(attacked);
+    BitboardPair enemyAttackedBy2 = pairSwap(attackedBy2);
+
+    BitboardPair attacksByPawns  = pairSwap(attacksOfPawns);
+    BitboardPair attacksByMinors = pairSwap(pairFrom(
+        ei->attackedBy[WHITE][KNIGHT] | ei->attackedBy[WHITE][BISHOP],
+        ei->attackedBy[BLACK][KNIGHT] | ei->attackedBy[BLACK][BISHOP]));
+    BitboardPair attacksByMajors = pairSwap(pairFrom(
+        ei->attackedBy[WHITE][ROOK  ] | ei->attackedBy[WHITE][QUEEN ],
+        ei->attackedBy[BLACK][ROOK  ] | ei->attackedBy[BLACK][QUEEN ]));
+    BitboardPair attacksByKing   = pairSwap(pairFrom(ei->attackedBy[WHITE][KING], ei->attackedBy[BLACK][KING]));
+
+    // Squares with more attackers, few defenders, and no pawn support
+    BitboardPair poorlyDefended = (enemyAttacked & ~attacked)
+                                | (enemyAttackedBy2 & ~attackedBy2 & ~attacksOfPawns);
+
+    BitboardPair weakMinors = minors & poorlyDefended;
+
+    // A friendly minor or major is overloaded if attacked and defended by exactly one
+    BitboardPair overloaded = (minors | rooks | queens)
+                            & attacked      & ~attackedBy2
+                            & enemyAttacked & ~enemyAttackedBy2;
+
+    // Look for enemy non-pawn pieces which we may threaten with a pawn advance.
+    // Don't consider pieces we already threaten, pawn moves which would be countered
+    // by a pawn capture, and squares which are completely unprotected by our pieces.
+    BitboardPair pushThreat  = pairAdvance(pawns, occupied);
+    pushThreat |= pairAdvance(pushThreat & ~attacksByPawns & pairFrom(RANK_3, RANK_6), occupied);
+    pushThreat &= ~attacksByPawns & (attacked | ~enemyAttacked);
+    pushThreat  = pairAttackSpan(pushThreat, enemy & ~attacksOfPawns);
+
+    // Penalty for each of our poorly supported pawns
+    count = pairPopcount(pawns & ~attacksByPawns & poorlyDefended);
+    eval += count * (uint64_t) Params.ThreatWeakPawn;
+    if (TRACE) tracePair(T.ThreatWeakPawn, count);
+
+    // Penalty for pawn threats against our minors
+    count = pairPopcount(minors & attacksByPawns);
+    eval += count * (uint64_t) Params.ThreatMinorAttackedByPawn;
+    if (TRACE) tracePair(T.ThreatMinorAttackedByPawn, count);
+
+    // Penalty for any minor threat against minor pieces
+    count = pairPopcount(minors & attacksByMinors);
+    eval += count * (uint64_t) Params.ThreatMinorAttackedByMinor;
+    if (TRACE) tracePair(T.ThreatMinorAttackedByMinor, count);
+
+    // Penalty for all major threats against poorly supported minors
+    count = pairPopcount(weakMinors & attacksByMajors);
+    eval += count * (uint64_t) Params.ThreatMinorAttackedByMajor;
+    if (TRACE) tracePair(T.ThreatMinorAttackedByMajor, count);
+
+    // Penalty for pawn and minor threats against our rooks
+    count = pairPopcount(rooks & (attacksByPawns | attacksByMinors));
+    eval += count * (uint64_t) Params.ThreatRookAttackedByLesser;
+    if (TRACE) tracePair(T.ThreatRookAttackedByLesser, count);
+
+    // Penalty for king threats against our poorly defended minors
+    count = pairPopcount(weakMinors & attacksByKing);
+    eval += count * (uint64_t) Params.ThreatMinorAttackedByKing;
+    if (TRACE) tracePair(T.ThreatMinorAttackedByKing, count);
+
+    // Penalty for king threats against our poorly defended rooks
+    count = pairPopcount(rooks & poorlyDefended & attacksByKing);
+    eval += count * (uint64_t) Params.ThreatRookAttackedByKing;
+    if (TRACE) tracePair(T.ThreatRookAttackedByKing, count);
+
+    // Penalty for any threat against our queens
+    count = pairPopcount(queens & enemyAttacked);
+    eval += count * (uint64_t) Params.ThreatQueenAttackedByOne;
+    if (TRACE) tracePair(T.ThreatQueenAttackedByOne, count);
+
+    // Penalty for any overloaded minors or majors
+    count = pairPopcount(overloaded);
+    eval += count * (uint64_t) Params.ThreatOverloadedPieces;
+    if (TRACE) tracePair(T.ThreatOverloadedPieces, count);
+
+    // Bonus for giving threats by safe pawn pushes
+    count = pairPopcount(pushThreat);
+    eval += count * (uint64_t) Params.ThreatByPawnPush;
+    if (TRACE) tracePair(T.ThreatByPawnPush, count);
+
+    return pairDifference(eval);
+}
+
+int evaluateSpacePaired(EvalInfo *ei, Board *board) {
+
+    // Both colours are evaluated at once, in the same fashion as evaluateThreatsPaired()
+
+    BitboardPair count, eval = { 0, 0 };
+
+    BitboardPair friendly = pairLoad(board->colours);
+    BitboardPair occupied = friendly | pairSwap(friendly);
+
+    BitboardPair attacked       = pairLoad(ei->attacked);
+    BitboardPair attackedBy2    = pairLoad(ei->attackedBy2);
+    BitboardPair attacksOfPawns = pairFrom(ei->attackedBy[WHITE][PAWN], ei->attackedBy[BLACK][PAWN]);
+
+    // Squares we attack with more enemy attackers and no friendly pawn attacks
+    BitboardPair uncontrolled =   pairSwap(attackedBy2) & attacked
+                              & ~attackedBy2 & ~attacksOfPawns;
+
+    // Penalty for restricted piece moves
+    count = pairPopcount(uncontrolled & occupied);
+    eval += count * (uint64_t) Params.SpaceRestrictPiece;
+    if (TRACE) tracePair(T.SpaceRestrictPiece, count);
+
+    count = pairPopcount(uncontrolled & ~occupied);
+    eval += count * (uint64_t) Params.SpaceRestrictEmpty;
+    if (TRACE) tracePair(T.SpaceRestrictEmpty, count);
+
+    // Bonus for uncontested central squares
+    // This is mostly relevant in the opening and the early middlegame, while rarely correct
+    // in the endgame where one rook or queen could control many uncontested squares.
+    // Thus we don't apply this term when below a threshold of minors/majors count.
+    if (      popcount(board->pieces[KNIGHT] | board->pieces[BISHOP])
+        + 2 * popcount(board->pieces[ROOK  ] | board->pieces[QUEEN ]) > 12) {
+        count = pairPopcount(~pairSwap(attacked) & (attacked | friendly) & pairOf(CENTER_BIG));
+        eval += count * (uint64_t) Params.SpaceCenterControl;
+        if (TRACE) tracePair(T.SpaceCenterControl, count);
+    }
+
+    return pairDifference(eval);
+}
+
+#if defined(USE_DISPATCH)
+    #pragma GCC pop_options
+#endif
+
+#endif
+
+int evaluateClosedness(EvalInfo *ei, Board *board) {
+
+    int closedness, count, eval = 0;
 
     // Compute Closedness factor for this position
     closedness = 1 * popcount(board->pieces[PAWN])
@@ -1204,13 +1424,13 @@ int evaluateClosedness(EvalInfo *ei, Board *board) {
     closedness = MAX(0, MIN(8, closedness / 3));
 
     // Evaluate Knights based on how Closed the position is
-    count = popcount(white & knights) - popcount(black & knights);
-    eval += count * ClosednessKnightAdjustment[closedness];
+    count = ei->material->knights;
+    eval += count * Params.ClosednessKnightAdjustment[closedness];
     if (TRACE) T.ClosednessKnightAdjustment[closedness][WHITE] += count;
 
     // Evaluate Rooks based on how Closed the position is
-    count = popcount(white & rooks) - popcount(black & rooks);
-    eval += count * ClosednessRookAdjustment[closedness];
+    count = ei->material->rooks;
+    eval += count * Params.ClosednessRookAdjustment[closedness];
     if (TRACE) T.ClosednessRookAdjustment[closedness][WHITE] += count;
 
     return eval;
@@ -1237,10 +1457,10 @@ int evaluateComplexity(EvalInfo *ei, Board *board, int eval) {
     uint64_t queens  = board->pieces[QUEEN ];
 
     // Compute the initiative bonus or malus for the attacking side
-    complexity =  ComplexityTotalPawns  * popcount(board->pieces[PAWN])
-               +  ComplexityPawnFlanks  * pawnsOnBothFlanks
-               +  ComplexityPawnEndgame * !(knights | bishops | rooks | queens)
-               +  ComplexityAdjustment;
+    complexity =  Params.ComplexityTotalPawns  * popcount(board->pieces[PAWN])
+               +  Params.ComplexityPawnFlanks  * pawnsOnBothFlanks
+               +  Params.ComplexityPawnEndgame * !(knights | bishops | rooks | queens)
+               +  Params.ComplexityAdjustment;
 
     if (TRACE) T.ComplexityTotalPawns[WHITE]  += popcount(board->pieces[PAWN]);
     if (TRACE) T.ComplexityPawnFlanks[WHITE]  += pawnsOnBothFlanks;
@@ -1255,12 +1475,13 @@ int evaluateComplexity(EvalInfo *ei, Board *board, int eval) {
     return MakeScore(0, v);
 }
 
-int evaluateScaleFactor(Board *board, int eval) {
+int evaluateScaleFactor(Board *board, int colour) {
 
     // Scale endgames based upon the remaining material. We check
     // for various Opposite Coloured Bishop cases, positions with
     // a lone Queen against multiple minor pieces and/or rooks, and
-    // positions with a Lone minor that should not be winnable
+    // positions with a Lone minor that should not be winnable. The
+    // result only depends on the Material Key, and is cached with it
 
     const uint64_t pawns   = board->pieces[PAWN  ];
     const uint64_t knights = board->pieces[KNIGHT];
@@ -1274,9 +1495,8 @@ int evaluateScaleFactor(Board *board, int eval) {
     const uint64_t white   = board->colours[WHITE];
     const uint64_t black   = board->colours[BLACK];
 
-    const uint64_t weak    = ScoreEG(eval) < 0 ? white : black;
-    const uint64_t strong  = ScoreEG(eval) < 0 ? black : white;
-
+    const uint64_t weak    = board->colours[!colour];
+    const uint64_t strong  = board->colours[ colour];
 
     // Check for opposite coloured bishops
     if (   onlyOne(white & bishops)
@@ -1367,6 +1587,9 @@ void initEvalInfo(Thread *thread, Board *board, EvalInfo *ei) {
     ei->kingAttackersCount[WHITE]  = ei->kingAttackersCount[BLACK]  = 0;
     ei->kingAttackersWeight[WHITE] = ei->kingAttackersWeight[BLACK] = 0;
 
+    // Phase, scale factors, and endgame dispatch are cached by material
+    ei->material = getMaterialEntry(thread, board);
+
     // Try to read a hashed Pawn King Eval. Otherwise, start from scratch
     ei->pkentry         = getCachedPawnKingEval(thread, board);
     ei->passedPawns     = ei->pkentry == NULL ? 0ull : ei->pkentry->passed;
@@ -1386,18 +1609,143 @@ void initEval() {
         const int sq1 = relativeSquare(WHITE, sq);
         const int sq2 = relativeSquare(BLACK, sq);
 
-        PSQT[WHITE_PAWN  ][sq] = + PawnValue   +   PawnPSQT[sq1];
-        PSQT[WHITE_KNIGHT][sq] = + KnightValue + KnightPSQT[sq1];
-        PSQT[WHITE_BISHOP][sq] = + BishopValue + BishopPSQT[sq1];
-        PSQT[WHITE_ROOK  ][sq] = + RookValue   +   RookPSQT[sq1];
-        PSQT[WHITE_QUEEN ][sq] = + QueenValue  +  QueenPSQT[sq1];
-        PSQT[WHITE_KING  ][sq] = + KingValue   +   KingPSQT[sq1];
-
-        PSQT[BLACK_PAWN  ][sq] = - PawnValue   -   PawnPSQT[sq2];
-        PSQT[BLACK_KNIGHT][sq] = - KnightValue - KnightPSQT[sq2];
-        PSQT[BLACK_BISHOP][sq] = - BishopValue - BishopPSQT[sq2];
-        PSQT[BLACK_ROOK  ][sq] = - RookValue   -   RookPSQT[sq2];
-        PSQT[BLACK_QUEEN ][sq] = - QueenValue  -  QueenPSQT[sq2];
-        PSQT[BLACK_KING  ][sq] = - KingValue   -   KingPSQT[sq2];
+        PSQT[WHITE_PAWN  ][sq] = + Params.PawnValue   +   Params.PawnPSQT[sq1];
+        PSQT[WHITE_KNIGHT][sq] = + Params.KnightValue + Params.KnightPSQT[sq1];
+        PSQT[WHITE_BISHOP][sq] = + Params.BishopValue + Params.BishopPSQT[sq1];
+        PSQT[WHITE_ROOK  ][sq] = + Params.RookValue   +   Params.RookPSQT[sq1];
+        PSQT[WHITE_QUEEN ][sq] = + Params.QueenValue  +  Params.QueenPSQT[sq1];
+        PSQT[WHITE_KING  ][sq] = + Params.KingValue   +   Params.KingPSQT[sq1];
+
+        PSQT[BLACK_PAWN  ][sq] = - Params.PawnValue   -   Params.PawnPSQT[sq2];
+        PSQT[BLACK_KNIGHT][sq] = - Params.KnightValue - Params.KnightPSQT[sq2];
+        PSQT[BLACK_BISHOP][sq] = - Params.BishopValue - Params.BishopPSQT[sq2];
+        PSQT[BLACK_ROOK  ][sq] = - Params.RookValue   -   Params.RookPSQT[sq2];
+        PSQT[BLACK_QUEEN ][sq] = - Params.QueenValue  -  Params.QueenPSQT[sq2];
+        PSQT[BLACK_KING  ][sq] = - Params.KingValue   -   Params.KingPSQT[sq2];
     }
 }
+
+static int parseEvalTerm(char *ptr, char *end, int *values, size_t length) {
+
+    // Each S(mg, eg) between the '=' and the ';' fills the next element,
+    // and we must find exactly as many as the term has elements
+
+    size_t found = 0;
+
+    while (ptr && (ptr = strstr(ptr, "S(")) != NULL && ptr < end) {
+
+        int mg = strtol(ptr + 2, &ptr, 10);
+        if (*ptr != ',' || found == length) return 0;
+
+        int eg = strtol(ptr + 1, &ptr, 10);
+        if (*ptr != ')') return 0;
+
+        values[found++] = MakeScore(mg, eg);
+    }
+
+    return found == length;
+}
+
+int loadEvalParams(const char *fname) {
+
+    // Parse a file in the format printed by the Tuner's printParameters(),
+    // where each term looks like "const int Name[...] = { S(mg, eg), ... };".
+    // Terms missing from the file keep their current values, and nothing is
+    // changed unless every term in the file is known and of the right length.
+    // A NULL fname restores the terms that Ethereal was compiled with
+
+    #define PARAM(term) { #term, offsetof(EvalParams, term), sizeof(Params.term) / sizeof(int) }
+
+    static const struct { const char *name; size_t offset, length; } Table[] = {
+        PARAM(PawnValue), PARAM(KnightValue), PARAM(BishopValue), PARAM(RookValue),
+        PARAM(QueenValue), PARAM(KingValue), PARAM(PawnPSQT), PARAM(KnightPSQT),
+        PARAM(BishopPSQT), PARAM(RookPSQT), PARAM(QueenPSQT), PARAM(KingPSQT),
+        PARAM(PawnCandidatePasser), PARAM(PawnIsolated), PARAM(PawnStacked),
+        PARAM(PawnBackwards), PARAM(PawnConnected32), PARAM(KnightOutpost),
+        PARAM(KnightBehindPawn), PARAM(KnightInSiberia), PARAM(KnightMobility),
+        PARAM(BishopPair), PARAM(BishopRammedPawns), PARAM(BishopOutpost),
+        PARAM(BishopBehindPawn), PARAM(BishopLongDiagonal), PARAM(BishopMobility),
+        PARAM(RookFile), PARAM(RookOnSeventh), PARAM(RookMobility),
+        PARAM(QueenRelativePin), PARAM(QueenMobility), PARAM(KingDefenders),
+        PARAM(KingPawnFileProximity), PARAM(KingShelter), PARAM(KingStorm),
+        PARAM(SafetyKnightWeight), PARAM(SafetyBishopWeight),
+        PARAM(SafetyRookWeight), PARAM(SafetyQueenWeight), PARAM(SafetyAttackValue),
+        PARAM(SafetyWeakSquares), PARAM(SafetyNoEnemyQueens),
+        PARAM(SafetySafeQueenCheck), PARAM(SafetySafeRookCheck),
+        PARAM(SafetySafeBishopCheck), PARAM(SafetySafeKnightCheck),
+        PARAM(SafetyAdjustment), PARAM(SafetyShelter), PARAM(SafetyStorm),
+        PARAM(PassedPawn), PARAM(PassedFriendlyDistance),
+        PARAM(PassedEnemyDistance), PARAM(PassedSafePromotionPath),
+        PARAM(ThreatWeakPawn), PARAM(ThreatMinorAttackedByPawn),
+        PARAM(ThreatMinorAttackedByMinor), PARAM(ThreatMinorAttackedByMajor),
+        PARAM(ThreatRookAttackedByLesser), PARAM(ThreatMinorAttackedByKing),
+        PARAM(ThreatRookAttackedByKing), PARAM(ThreatQueenAttackedByOne),
+        PARAM(ThreatOverloadedPieces), PARAM(ThreatByPawnPush),
+        PARAM(SpaceRestrictPiece), PARAM(SpaceRestrictEmpty),
+        PARAM(SpaceCenterControl), PARAM(ClosednessKnightAdjustment),
+        PARAM(ClosednessRookAdjustment), PARAM(ComplexityTotalPawns),
+        PARAM(ComplexityPawnFlanks), PARAM(ComplexityPawnEndgame),
+        PARAM(ComplexityAdjustment),
+    };
+
+    #undef PARAM
+
+    static EvalParams Builtin;
+    static int saved = 0;
+
+    FILE *fin;
+    char *text, *ptr, *end;
+    long size;
+    int loaded = 0, error = 0;
+
+    if (!saved)
+        Builtin = Params, saved = 1;
+
+    if (fname == NULL) {
+        Params = Builtin, initEval();
+        return 1;
+    }
+
+    if ((fin = fopen(fname, "rb")) == NULL)
+        return 0;
+
+    fseek(fin, 0, SEEK_END);
+    size = ftell(fin);
+    fseek(fin, 0, SEEK_SET);
+
+    text = calloc(size + 1, sizeof(char));
+    error = fread(text, sizeof(char), size, fin) != (size_t) size;
+    fclose(fin);
+
+    // Work on a copy, so a bad file never leaves us with a partial update
+    EvalParams params = Params;
+
+    for (ptr = text; !error && (ptr = strstr(ptr, "const int ")) != NULL; ptr = end) {
+
+        char name[64];
+        size_t term, count = sizeof(Table) / sizeof(Table[0]);
+        ptr += strlen("const int ");
+
+        if (   sscanf(ptr, "%63[A-Za-z0-9_]", name) != 1
+            || (end = strchr(ptr, ';')) == NULL) {
+            error = 1; break;
+        }
+
+        for (term = 0; term < count; term++)
+            if (!strcmp(name, Table[term].name)) break;
+
+        error = term == count || !parseEvalTerm(strchr(ptr, '='), end,
+            (int*) ((char*) &params + Table[term].offset), Table[term].length);
+
+        loaded += !error;
+    }
+
+    free(text);
+
+    if (error || !loaded)
+        return 0;
+
+    Params = params;
+    initEval(); // Refold the Material and PSQT terms
+    return loaded;
+}
@@ -39,6 +39,89 @@ enum {
     SCALE_LARGE_PAWN_ADV   = 144,
 };
 
+struct EvalParams {
+
+    // Read by every full evaluation, in the order evaluatePieces() and the
+    // later stages of evaluateBoard() reach them, so they share few cache lines
+    int KnightOutpost[2][2];
+    int KnightBehindPawn;
+    int KnightInSiberia[4];
+    int KnightMobility[9];
+    int BishopPair;
+    int BishopRammedPawns;
+    int BishopOutpost[2][2];
+    int BishopBehindPawn;
+    int BishopLongDiagonal;
+    int BishopMobility[14];
+    int RookFile[2];
+    int RookOnSeventh;
+    int RookMobility[15];
+    int QueenRelativePin;
+    int QueenMobility[28];
+    int KingDefenders[12];
+    int SafetyKnightWeight;
+    int SafetyBishopWeight;
+    int SafetyRookWeight;
+    int SafetyQueenWeight;
+    int SafetyAttackValue;
+    int SafetyWeakSquares;
+    int SafetyNoEnemyQueens;
+    int SafetySafeQueenCheck;
+    int SafetySafeRookCheck;
+    int SafetySafeBishopCheck;
+    int SafetySafeKnightCheck;
+    int SafetyAdjustment;
+    int PassedPawn[2][2][RANK_NB];
+    int PassedFriendlyDistance[FILE_NB];
+    int PassedEnemyDistance[FILE_NB];
+    int PassedSafePromotionPath;
+    int ThreatWeakPawn;
+    int ThreatMinorAttackedByPawn;
+    int ThreatMinorAttackedByMinor;
+    int ThreatMinorAttackedByMajor;
+    int ThreatRookAttackedByLesser;
+    int ThreatMinorAttackedByKing;
+    int ThreatRookAttackedByKing;
+    int ThreatQueenAttackedByOne;
+    int ThreatOverloadedPieces;
+    int ThreatByPawnPush;
+    int SpaceRestrictPiece;
+    int SpaceRestrictEmpty;
+    int SpaceCenterControl;
+    int ClosednessKnightAdjustment[9];
+    int ClosednessRookAdjustment[9];
+    int ComplexityTotalPawns;
+    int ComplexityPawnFlanks;
+    int ComplexityPawnEndgame;
+    int ComplexityAdjustment;
+
+    // Only read when the Pawn King Table misses, by evaluatePawns() and evaluateKingsPawns()
+    int PawnCandidatePasser[2][RANK_NB];
+    int PawnIsolated[FILE_NB];
+    int PawnStacked[2][FILE_NB];
+    int PawnBackwards[2][RANK_NB];
+    int PawnConnected32[32];
+    int KingPawnFileProximity[FILE_NB];
+    int KingShelter[2][FILE_NB][RANK_NB];
+    int KingStorm[2][FILE_NB/2][RANK_NB];
+    int SafetyShelter[2][RANK_NB];
+    int SafetyStorm[2][RANK_NB];
+
+    // Only read by initEval(), which folds them into PSQT[][]
+    int PawnValue;
+    int KnightValue;
+    int BishopValue;
+    int RookValue;
+    int QueenValue;
+    int KingValue;
+    int PawnPSQT[SQUARE_NB];
+    int KnightPSQT[SQUARE_NB];
+    int BishopPSQT[SQUARE_NB];
+    int RookPSQT[SQUARE_NB];
+    int QueenPSQT[SQUARE_NB];
+    int KingPSQT[SQUARE_NB];
+};
+
 struct EvalTrace {
     int PawnValue[COLOUR_NB];
     int KnightValue[COLOUR_NB];
@@ -136,9 +219,12 @@ struct EvalInfo {
     int pkeval[COLOUR_NB];
     int pksafety[COLOUR_NB];
     PKEntry *pkentry;
+    MaterialEntry *material;
 };
 
 int evaluateBoard(Thread *thread, Board *board);
+int evaluateBoardLazy(Thread *thread, Board *board, int alpha, int beta);
+int evaluatePhase(Board *board);
 int evaluatePieces(EvalInfo *ei, Board *board);
 int evaluatePawns(EvalInfo *ei, Board *board, int colour);
 int evaluateKnights(EvalInfo *ei, Board *board, int colour);
@@ -150,15 +236,19 @@ int evaluateKings(EvalInfo *ei, Board *board, int colour);
 int evaluatePassed(EvalInfo *ei, Board *board, int colour);
 int evaluateThreats(EvalInfo *ei, Board *board, int colour);
 int evaluateSpace(EvalInfo *ei, Board *board, int colour);
+int evaluateThreatsPaired(EvalInfo *ei, Board *board);
+int evaluateSpacePaired(EvalInfo *ei, Board *board);
 int evaluateClosedness(EvalInfo *ei, Board *board);
 int evaluateComplexity(EvalInfo *ei, Board *board, int eval);
-int evaluateScaleFactor(Board *board, int eval);
+int evaluateScaleFactor(Board *board, int colour);
 void initEvalInfo(Thread *thread, Board *board, EvalInfo *ei);
 void initEval();
+int loadEvalParams(const char *fname);
 
 #define MakeScore(mg, eg) ((int)((unsigned int)(eg) << 16) + (mg))
 #define ScoreMG(s) ((int16_t)((uint16_t)((unsigned)((s)))))
 #define ScoreEG(s) ((int16_t)((uint16_t)((unsigned)((s) + 0x8000) >> 16)))
 
+extern EvalParams Params;
 extern int PSQT[32][SQUARE_NB];
 extern const int Tempo;
@@ -23,8 +23,13 @@
 #include "attacks.h"
 #include "bitboards.h"
 #include "masks.h"
+#include "tablegen.h"
 #include "types.h"
 
+#if defined(USE_PRECOMPUTED)
+    #include "precomputed/masks.h"
+#else
+
 int DistanceBetween[SQUARE_NB][SQUARE_NB];
 int KingPawnFileDistance[FILE_NB][1 << FILE_NB];
 uint64_t BitsBetweenMasks[SQUARE_NB][SQUARE_NB];
@@ -37,6 +42,16 @@ uint64_t PawnConnectedMasks[COLOUR_NB][SQUARE_NB];
 uint64_t OutpostSquareMasks[COLOUR_NB][SQUARE_NB];
 uint64_t OutpostRanksMasks[COLOUR_NB];
 
+#endif
+
+#if defined(USE_PRECOMPUTED)
+
+void initMasks() {
+    // Tables were written out when building
+}
+
+#else
+
 void initMasks() {
 
     // Init a table for the distance between two given squares
@@ -137,6 +152,22 @@ void initMasks() {
     }
 }
 
+#endif
+
+void writeMaskTables(FILE *fout) {
+    writeTable(fout, "const int DistanceBetween", DistanceBetween, TABLE_INT, 2, SQUARE_NB, SQUARE_NB);
+    writeTable(fout, "const int KingPawnFileDistance", KingPawnFileDistance, TABLE_INT, 2, FILE_NB, 1 << FILE_NB);
+    writeTable(fout, "const uint64_t BitsBetweenMasks", BitsBetweenMasks, TABLE_U64, 2, SQUARE_NB, SQUARE_NB);
+    writeTable(fout, "const uint64_t KingAreaMasks", KingAreaMasks, TABLE_U64, 2, COLOUR_NB, SQUARE_NB);
+    writeTable(fout, "const uint64_t ForwardRanksMasks", ForwardRanksMasks, TABLE_U64, 2, COLOUR_NB, RANK_NB);
+    writeTable(fout, "const uint64_t ForwardFileMasks", ForwardFileMasks, TABLE_U64, 2, COLOUR_NB, SQUARE_NB);
+    writeTable(fout, "const uint64_t AdjacentFilesMasks", AdjacentFilesMasks, TABLE_U64, 1, FILE_NB);
+    writeTable(fout, "const uint64_t PassedPawnMasks", PassedPawnMasks, TABLE_U64, 2, COLOUR_NB, SQUARE_NB);
+    writeTable(fout, "const uint64_t PawnConnectedMasks", PawnConnectedMasks, TABLE_U64, 2, COLOUR_NB, SQUARE_NB);
+    writeTable(fout, "const uint64_t OutpostSquareMasks", OutpostSquareMasks, TABLE_U64, 2, COLOUR_NB, SQUARE_NB);
+    writeTable(fout, "const uint64_t OutpostRanksMasks", OutpostRanksMasks, TABLE_U64, 1, COLOUR_NB);
+}
+
 int distanceBetween(int s1, int s2) {
     assert(0 <= s1 && s1 < SQUARE_NB);
     assert(0 <= s2 && s2 < SQUARE_NB);
@@ -0,0 +1,322 @@
+/*
+  Ethereal is a UCI chess playing engine authored by Andrew Grant.
+  <https://github.com/AndyGrant/Ethereal>     <andrew@grantnet.us>
+
+  Ethereal is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Ethereal is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "board.h"
+#include "mate.h"
+#include "move.h"
+#include "movegen.h"
+#include "search.h"
+#include "thread.h"
+#include "time.h"
+#include "types.h"
+#include "uci.h"
+
+extern volatile int ABORT_SIGNAL; // Defined by search.c
+
+static PNEntry *ProofTable; // Allocated on the first "go mate"
+
+static const int ProgressTimerMS = 2500;
+
+/*
+    Ethereal answers "go mate N" with a depth-first proof-number search
+    (df-pn), written in the negamax form. Every node holds a pair (phi,
+    delta), which are the proof and disproof numbers from the viewpoint
+    of the side to move. The attacker moves at OR nodes and the defender
+    at AND nodes. A node is solved once either phi or delta reaches zero.
+
+    Nodes are keyed by hash and by the number of plies remaining, so a
+    mate proven with R plies remaining also holds with more plies, and a
+    refutation with R plies remaining also holds with fewer plies
+*/
+
+typedef struct MateSearch {
+    Thread *thread;
+    Limits *limits;
+    int attacker, aborted;
+    int plies, lastReport;
+} MateSearch;
+
+static uint32_t pnAdd(uint32_t a, uint32_t b) {
+    return MIN(PN_INFINITY, a + b);
+}
+
+static int attackerWins(const PNEntry *entry, int orNode) {
+    return orNode ? entry->phi == 0 : entry->delta == 0;
+}
+
+static int attackerFails(const PNEntry *entry, int orNode) {
+    return orNode ? entry->delta == 0 : entry->phi == 0;
+}
+
+static int probeProofTable(Board *board, int plies, int orNode, uint32_t *phi, uint32_t *delta) {
+
+    const PNEntry *entry = &ProofTable[board->hash & (PN_TABLE_NB - 1)];
+
+    if (entry->hash != board->hash)
+        return 0;
+
+    // Mates proven with fewer plies apply to the current search
+    if (attackerWins(entry, orNode) && entry->plies <= plies) {
+        *phi = orNode ? 0 : PN_INFINITY, *delta = orNode ? PN_INFINITY : 0;
+        return 1;
+    }
+
+    // Refutations found with more plies apply to the current search
+    if (attackerFails(entry, orNode) && entry->plies >= plies) {
+        *phi = orNode ? PN_INFINITY : 0, *delta = orNode ? 0 : PN_INFINITY;
+        return 1;
+    }
+
+    // Unsolved nodes are only usable with an exact number of plies
+    if (entry->plies == plies) {
+        *phi = entry->phi, *delta = entry->delta;
+        return 1;
+    }
+
+    return 0;
+}
+
+static void storeProofTable(Board *board, int plies, uint32_t phi, uint32_t delta, uint16_t move) {
+
+    PNEntry *entry = &ProofTable[board->hash & (PN_TABLE_NB - 1)];
+
+    entry->hash  = board->hash;
+    entry->phi   = phi;
+    entry->delta = delta;
+    entry->plies = plies;
+    entry->move  = move;
+}
+
+static void initialProofNumbers(MateSearch *ms, int plies, uint32_t *phi, uint32_t *delta) {
+
+    // Assign the initial (phi, delta) for an unexplored node, resolving
+    // any terminal nodes. Otherwise the phi is set to one, and the delta
+    // is the number of legal moves, since each must be refuted in turn
+
+    Board *const board = &ms->thread->board;
+    const int orNode = board->turn == ms->attacker;
+
+    uint16_t moves[MAX_MOVES];
+    int count;
+
+    if (probeProofTable(board, plies, orNode, phi, delta))
+        return;
+
+    count = genAllLegalMoves(board, moves);
+
+    // Checkmate and stalemate both lose for the side to move, from
+    // the viewpoint of the search, except stalemating the defender
+    if (!count && (orNode || board->kingAttackers))
+        *phi = PN_INFINITY, *delta = 0;
+
+    // Defender survived until the plies ran out, or was stalemated
+    else if (!count || (!orNode && plies == 0))
+        *phi = 0, *delta = PN_INFINITY;
+
+    else *phi = 1, *delta = count;
+
+    // Keep terminal nodes around for building the PV later
+    if (*phi == 0 || *delta == 0)
+        storeProofTable(board, plies, *phi, *delta, NONE_MOVE);
+}
+
+static int mateSearchShouldStop(MateSearch *ms) {
+
+    Thread *const thread = ms->thread;
+    Limits *const limits = ms->limits;
+
+    // Only poll the clock and signals once every 1024 nodes
+    if ((thread->nodes & 1023) != 1023)
+        return ABORT_SIGNAL;
+
+    // Proofs can run for a long time, so report the progress now and then
+    const int elapsed = elapsedTime(thread->info);
+    if (elapsed >= ms->lastReport + ProgressTimerMS) {
+        uciReportProgress(thread, ms->plies);
+        ms->lastReport = elapsed;
+    }
+
+    return ABORT_SIGNAL
+        || (limits->limitedByTime  && elapsedTime(thread->info) >= limits->timeLimit)
+        || (limits->limitedByNodes && thread->nodes >= limits->nodeLimit);
+}
+
+static void proofSearch(MateSearch *ms, int plies, uint32_t thphi, uint32_t thdelta, uint32_t *phi, uint32_t *delta) {
+
+    Thread *const thread = ms->thread;
+    Board *const board   = &thread->board;
+
+    uint16_t moves[MAX_MOVES], bestMove = NONE_MOVE;
+    uint32_t cphi[MAX_MOVES], cdelta[MAX_MOVES];
+    int count, best;
+
+    thread->nodes++;
+    thread->seldepth = MAX(thread->seldepth, thread->height);
+
+    if ((ms->aborted = ms->aborted || mateSearchShouldStop(ms)))
+        return;
+
+    // Expand the node, using the Proof Table for any known children
+    count = genAllLegalMoves(board, moves);
+    for (int i = 0; i < count; i++) {
+        applyLegal(thread, board, moves[i]);
+        initialProofNumbers(ms, plies - 1, &cphi[i], &cdelta[i]);
+        revert(thread, board, moves[i]);
+    }
+
+    while (1) {
+
+        uint32_t delta2 = PN_INFINITY;
+        best = 0, *phi = PN_INFINITY, *delta = 0;
+
+        // Phi is the easiest child to win, while delta sums the
+        // work required to refute every child. Track the two most
+        // proving children, to bound the search of the best child
+        for (int i = 0; i < count; i++) {
+
+            *delta = pnAdd(*delta, cphi[i]);
+
+            if (cdelta[i] < *phi)
+                delta2 = *phi, *phi = cdelta[i], best = i;
+
+            else if (cdelta[i] < delta2)
+                delta2 = cdelta[i];
+        }
+
+        bestMove = moves[best];
+
+        if (*phi >= thphi || *delta >= thdelta || ms->aborted)
+            break;
+
+        // Child thresholds, with a small (1 + epsilon) enlargement
+        // of the second best bound to avoid thrashing between siblings
+        uint32_t cthphi   = MIN(PN_INFINITY, (uint64_t) thdelta + cphi[best] - *delta);
+        uint32_t cthdelta = MIN(thphi, pnAdd(delta2, delta2 / 4 + 1));
+
+        applyLegal(thread, board, moves[best]);
+        proofSearch(ms, plies - 1, cthphi, cthdelta, &cphi[best], &cdelta[best]);
+        revert(thread, board, moves[best]);
+    }
+
+    if (!ms->aborted)
+        storeProofTable(board, plies, *phi, *delta, bestMove);
+}
+
+static void collectMatePV(MateSearch *ms, int plies, PVariation *pv) {
+
+    // Walk the proof from the root, taking the quickest mate for the
+    // attacker, and the reply holding out the longest for the defender
+
+    Thread *const thread = ms->thread;
+    Board *const board   = &thread->board;
+    const int orNode     = board->turn == ms->attacker;
+
+    uint16_t moves[MAX_MOVES], move = NONE_MOVE;
+    uint32_t phi, delta;
+    int count, found, bestPlies = 0;
+
+    if (plies <= 0 || pv->length >= MAX_PLY)
+        return;
+
+    count = genAllLegalMoves(board, moves);
+
+    for (int i = 0; i < count; i++) {
+
+        applyLegal(thread, board, moves[i]);
+
+        const PNEntry *entry = &ProofTable[board->hash & (PN_TABLE_NB - 1)];
+        found = probeProofTable(board, plies - 1, !orNode, &phi, &delta)
+             && attackerWins(entry, !orNode) && entry->hash == board->hash;
+
+        if (found && (  move == NONE_MOVE
+                      || ( orNode && entry->plies < bestPlies)
+                      || (!orNode && entry->plies > bestPlies)))
+            move = moves[i], bestPlies = entry->plies;
+
+        revert(thread, board, moves[i]);
+    }
+
+    if (move == NONE_MOVE)
+        return;
+
+    pv->line[pv->length++] = move;
+    applyLegal(thread, board, move);
+    collectMatePV(ms, plies - 1, pv);
+    revert(thread, board, move);
+}
+
+int mateSearch(Thread *thread, Limits *limits) {
+
+    // Search for the shortest mate of at most limits->mateLimit moves,
+    // one iteration per mate distance. Once a mate is proven, it is
+    // reported and placed into SearchInfo like a completed iteration.
+    // Otherwise the most promising root move is left in SearchInfo
+
+    MateSearch ms = { thread, limits, thread->board.turn, 0, 0, 0 };
+    SearchInfo *const info = thread->info;
+    Board *const board     = &thread->board;
+
+    uint16_t moves[MAX_MOVES];
+    uint32_t phi, delta;
+
+    // Reports would otherwise carry over the last search's MultiPV line
+    thread->multiPV = thread->seldepth = 0;
+
+    if (!(info->bestMoves[0] = genAllLegalMoves(board, moves) ? moves[0] : NONE_MOVE))
+        return 0;
+
+    if (ProofTable == NULL)
+        ProofTable = malloc(PN_TABLE_NB * sizeof(PNEntry));
+    memset(ProofTable, 0, PN_TABLE_NB * sizeof(PNEntry));
+
+    for (int mate = 1; mate <= limits->mateLimit && !ms.aborted; mate++) {
+
+        const int plies = ms.plies = 2 * mate - 1;
+
+        proofSearch(&ms, plies, PN_INFINITY, PN_INFINITY, &phi, &delta);
+
+        // Keep the most promising root move as a fallback
+        const PNEntry *entry = &ProofTable[board->hash & (PN_TABLE_NB - 1)];
+        if (entry->hash == board->hash && entry->move != NONE_MOVE)
+            info->bestMoves[0] = entry->move;
+
+        if (ms.aborted || phi != 0)
+            continue;
+
+        // Mate proven, so update SearchInfo and report the PV
+        thread->depth = plies;
+        thread->pv.length = 0;
+        collectMatePV(&ms, plies, &thread->pv);
+
+        thread->seldepth               = MAX(thread->seldepth, plies);
+        info->depth                    = plies;
+        info->values[plies]            = MATE - plies;
+        info->bestMoves[plies]         = thread->pv.line[0];
+        info->ponderMoves[plies]       = thread->pv.length > 1 ? thread->pv.line[1] : NONE_MOVE;
+
+        uciReport(thread, -MATE, MATE, MATE - plies);
+        return 1;
+    }
+
+    return 0;
+}
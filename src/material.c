@@ -0,0 +1,125 @@
+/*
+  Ethereal is a UCI chess playing engine authored by Andrew Grant.
+  <https://github.com/AndyGrant/Ethereal>     <andrew@grantnet.us>
+
+  Ethereal is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Ethereal is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include <stdint.h>
+
+#include "bitboards.h"
+#include "board.h"
+#include "evaluate.h"
+#include "material.h"
+#include "nneval.h"
+#include "tablegen.h"
+#include "thread.h"
+#include "types.h"
+
+#if defined(USE_PRECOMPUTED)
+    #include "precomputed/material.h"
+#else
+uint64_t MaterialKeys[32][SQUARE_NB];
+#endif
+
+#if defined(USE_PRECOMPUTED)
+
+void initMaterial() {
+    // Tables were written out when building
+}
+
+#else
+
+void initMaterial() {
+
+    // Each piece adds one to its own 4-bit counter. Bishops use one of
+    // two counters based on their square colour, so that the key knows
+    // about Opposite Coloured Bishops. EMPTY keeps an all zero row
+
+    for (int piece = PAWN; piece <= KING; piece++) {
+        for (int colour = WHITE; colour <= BLACK; colour++) {
+            for (int sq = 0; sq < SQUARE_NB; sq++) {
+
+                int slot = piece + (piece > BISHOP)
+                         + (piece == BISHOP && !testBit(WHITE_SQUARES, sq));
+
+                MaterialKeys[makePiece(piece, colour)][sq]
+                    = 1ull << (4 * (MATERIAL_NB * colour + slot));
+            }
+        }
+    }
+}
+
+#endif
+
+void writeMaterialTables(FILE *fout) {
+    writeTable(fout, "const uint64_t MaterialKeys", MaterialKeys, TABLE_U64, 2, 32, SQUARE_NB);
+}
+
+int materialCount(uint64_t matkey, int colour, int slot) {
+    return (matkey >> (4 * (MATERIAL_NB * colour + slot))) & 0xF;
+}
+
+int materialIsDrawn(uint64_t matkey) {
+
+    // Check for KvK, KvN, KvB, and KvNN. One side must have only its King,
+    // and the other side no Pawns, Rooks, or Queens, and then either at
+    // most a single minor piece or exactly two Knights
+
+    const uint64_t KingOnly = 1ull << (4 * MATERIAL_KING);
+    const uint64_t white    = matkey & ((1ull << (4 * MATERIAL_NB)) - 1);
+    const uint64_t black    = matkey >> (4 * MATERIAL_NB);
+    const int strong        = white == KingOnly ? BLACK : WHITE;
+
+    if (white != KingOnly && black != KingOnly)
+        return 0;
+
+    if (   materialCount(matkey, strong, MATERIAL_PAWN )
+        || materialCount(matkey, strong, MATERIAL_ROOK )
+        || materialCount(matkey, strong, MATERIAL_QUEEN))
+        return 0;
+
+    int knights = materialCount(matkey, strong, MATERIAL_KNIGHT);
+    int bishops = materialCount(matkey, strong, MATERIAL_LIGHT_BISHOP)
+                + materialCount(matkey, strong, MATERIAL_DARK_BISHOP);
+
+    return knights + bishops <= 1 || (!bishops && knights <= 2);
+}
+
+MaterialEntry* getMaterialEntry(Thread *thread, Board *board) {
+
+    // The key has few set bits and they sit in its lower half, so mix
+    // it before indexing. Every field of an entry is derived only from
+    // the material itself, so an entry is valid for any matching Board
+
+    const uint64_t matkey = board->matkey;
+    const uint64_t index  = (matkey * 0x9E3779B97F4A7C15ull) >> (64 - MATERIAL_CACHE_KEY_SIZE);
+
+    MaterialEntry *entry = &thread->mttable[index];
+
+    if (entry->matkey != matkey) {
+        entry->matkey       = matkey;
+        entry->phase        = evaluatePhase(board);
+        entry->egtype       = endgameNetworkIndex(board);
+        entry->knights      = materialCount(matkey, WHITE, MATERIAL_KNIGHT)
+                            - materialCount(matkey, BLACK, MATERIAL_KNIGHT);
+        entry->rooks        = materialCount(matkey, WHITE, MATERIAL_ROOK)
+                            - materialCount(matkey, BLACK, MATERIAL_ROOK);
+        entry->scale[WHITE] = evaluateScaleFactor(board, WHITE);
+        entry->scale[BLACK] = evaluateScaleFactor(board, BLACK);
+    }
+
+    return entry;
+}
@@ -0,0 +1,54 @@
+/*
+  Ethereal is a UCI chess playing engine authored by Andrew Grant.
+  <https://github.com/AndyGrant/Ethereal>     <andrew@grantnet.us>
+
+  Ethereal is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Ethereal is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <stdint.h>
+
+#include "types.h"
+
+enum {
+    MATERIAL_CACHE_KEY_SIZE = 12,
+    MATERIAL_CACHE_SIZE     = 1 << MATERIAL_CACHE_KEY_SIZE,
+};
+
+// The Material Key packs a 4-bit count for each colour and piece type,
+// with Bishops split by the colour of their square, so that the key is
+// exact. Kings are counted as well, which keeps every key non-zero
+
+enum {
+    MATERIAL_PAWN, MATERIAL_KNIGHT, MATERIAL_LIGHT_BISHOP, MATERIAL_DARK_BISHOP,
+    MATERIAL_ROOK, MATERIAL_QUEEN, MATERIAL_KING, MATERIAL_NB
+};
+
+struct MaterialEntry {
+    uint64_t matkey;
+    int16_t phase;
+    int8_t egtype, knights, rooks;
+    uint8_t scale[COLOUR_NB];
+};
+
+typedef MaterialEntry MaterialTable[MATERIAL_CACHE_SIZE];
+
+extern TABLE uint64_t MaterialKeys[32][SQUARE_NB];
+
+void initMaterial();
+int materialCount(uint64_t matkey, int colour, int slot);
+int materialIsDrawn(uint64_t matkey);
+MaterialEntry* getMaterialEntry(Thread *thread, Board *board);
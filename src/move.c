@@ -20,22 +20,33 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
+#include "attackmap.h"
 #include "attacks.h"
 #include "bitboards.h"
 #include "board.h"
 #include "evaluate.h"
 #include "masks.h"
+#include "material.h"
 #include "move.h"
 #include "movegen.h"
+#include "nnue.h"
 #include "search.h"
 #include "thread.h"
 #include "types.h"
 #include "uci.h"
 #include "zobrist.h"
 
-static void updateCastleZobrist(Board *board, uint64_t oldRooks, uint64_t newRooks) {
-    uint64_t diff = oldRooks ^ newRooks;
+static void updateCastleRights(Board *board, uint64_t lost) {
+
+    // Rights are lost by moving the King, or by moving or capturing one of
+    // the castling Rooks. Castling Rooks are all on their back rank, so the
+    // King's rank covers all the rights for that colour when the King moves
+
+    uint64_t diff = board->castleRooks & lost;
+
+    board->castleRooks ^= diff;
     while (diff)
         board->hash ^= ZobristCastleKeys[poplsb(&diff)];
 }
@@ -59,14 +70,17 @@ int apply(Thread *thread, Board *board, uint16_t move) {
 
     else {
 
+        // Reject illegal moves before doing any work
+        if (!moveIsLegal(board, move))
+            return 0;
+
         // Track some move information for history lookups
         thread->moveStack[thread->height] = move;
         thread->pieceStack[thread->height] = pieceType(board->squares[MoveFrom(move)]);
 
-        // Apply the move and reject if illegal
+        // Apply the move, which is now known to be legal
         applyMove(board, move, &thread->undoStack[thread->height]);
-        if (!moveWasLegal(board))
-            return revertMove(board, move, &thread->undoStack[thread->height]), 0;
+        assert(moveWasLegal(board));
     }
 
     // Advance the Stack before updating
@@ -96,14 +110,24 @@ void applyMove(Board *board, uint16_t move, Undo *undo) {
         applyEnpassMove, applyPromotionMove
     };
 
+    const int epSquare = board->epSquare;
+
+#ifdef USE_COPY_MAKE
+    // Save the hot part of the Board whole, for revertMove() to copy back
+    memcpy(undo->board, board, BOARD_HOT_SIZE);
+#else
     // Save information which is hard to recompute
     undo->hash            = board->hash;
     undo->pkhash          = board->pkhash;
+    undo->matkey          = board->matkey;
     undo->kingAttackers   = board->kingAttackers;
+    undo->pinned          = board->pinned;
     undo->castleRooks     = board->castleRooks;
     undo->epSquare        = board->epSquare;
     undo->halfMoveCounter = board->halfMoveCounter;
     undo->psqtmat         = board->psqtmat;
+    memcpy(undo->pkaccum, board->pkaccum, sizeof(board->pkaccum));
+#endif
 
     // Store hash history for repetition checking
     board->history[board->numMoves++] = board->hash;
@@ -113,21 +137,32 @@ void applyMove(Board *board, uint16_t move, Undo *undo) {
     if (board->epSquare != -1)
         board->hash ^= ZobristEnpassKeys[fileOf(board->epSquare)];
 
+    // Piece changes are recorded for a lazy NNUE update
+    if (board->nnue != NULL)
+        nnuePush(board);
+
     // Run the correct move application function
     table[MoveType(move) >> 12](board, move, undo);
 
     // No function updated epsquare so we reset
-    if (board->epSquare == undo->epSquare)
+    if (board->epSquare == epSquare)
         board->epSquare = -1;
 
     // No function updates this so we do it here
     board->turn = !board->turn;
 
-    // Need king attackers to verify move legality
+    // Recompute the attacks of any pieces affected by the move
+#ifdef USE_ATTACK_MAPS
+    updateAttackMap(board, attackMapChanges(move));
+#endif
+
+    // Need king attackers to verify move legality. Pinned
+    // pieces are only found once a legality check needs them
     board->kingAttackers = attackersToKingSquare(board);
+    board->pinned = PINNED_UNKNOWN;
 }
 
-void applyNormalMove(Board *board, uint16_t move, Undo *undo) {
+INLINE void applyNormal(Board *board, uint16_t move, Undo *undo, const int US) {
 
     const int from = MoveFrom(move);
     const int to = MoveTo(move);
@@ -144,8 +179,8 @@ void applyNormalMove(Board *board, uint16_t move, Undo *undo) {
     else
         board->halfMoveCounter += 1;
 
-    board->pieces[fromType]     ^= (1ull << from) ^ (1ull << to);
-    board->colours[board->turn] ^= (1ull << from) ^ (1ull << to);
+    board->pieces[fromType] ^= (1ull << from) ^ (1ull << to);
+    board->colours[US]      ^= (1ull << from) ^ (1ull << to);
 
     board->pieces[toType]    ^= (1ull << to);
     board->colours[toColour] ^= (1ull << to);
@@ -154,39 +189,59 @@ void applyNormalMove(Board *board, uint16_t move, Undo *undo) {
     board->squares[to]   = fromPiece;
     undo->capturePiece   = toPiece;
 
-    board->castleRooks &= board->castleMasks[from];
-    board->castleRooks &= board->castleMasks[to];
-    updateCastleZobrist(board, undo->castleRooks, board->castleRooks);
+    if (board->nnue != NULL) {
+        nnueMovePiece(board, fromPiece, from, to);
+        if (toPiece != EMPTY) nnueRemovePiece(board, toPiece, to);
+    }
+
+    updateCastleRights(board, (1ull << from) | (1ull << to)
+                     | (fromType == KING ? (US == WHITE ? RANK_1 : RANK_8) : 0ull));
 
     board->psqtmat += PSQT[fromPiece][to]
                    -  PSQT[fromPiece][from]
                    -  PSQT[toPiece][to];
 
+    board->matkey  -= MaterialKeys[toPiece][to];
+
     board->hash    ^= ZobristKeys[fromPiece][from]
                    ^  ZobristKeys[fromPiece][to]
                    ^  ZobristKeys[toPiece][to]
                    ^  ZobristTurnKey;
 
-    if (fromType == PAWN || fromType == KING)
+    if (fromType == PAWN || fromType == KING) {
         board->pkhash ^= ZobristKeys[fromPiece][from]
                       ^  ZobristKeys[fromPiece][to];
+        subPKAccumulator(board->pkaccum, fromPiece, from);
+        addPKAccumulator(board->pkaccum, fromPiece, to);
+    }
 
-    if (toType == PAWN)
+    if (toType == PAWN) {
         board->pkhash ^= ZobristKeys[toPiece][to];
+        subPKAccumulator(board->pkaccum, toPiece, to);
+    }
 
     if (fromType == PAWN && (to ^ from) == 16) {
 
         uint64_t enemyPawns =  board->pieces[PAWN]
-                            &  board->colours[!board->turn]
+                            &  board->colours[!US]
                             &  adjacentFilesMasks(fileOf(from))
-                            & (board->turn == WHITE ? RANK_4 : RANK_5);
+                            & (US == WHITE ? RANK_4 : RANK_5);
         if (enemyPawns) {
-            board->epSquare = board->turn == WHITE ? from + 8 : from - 8;
+            board->epSquare = US == WHITE ? from + 8 : from - 8;
             board->hash ^= ZobristEnpassKeys[fileOf(from)];
         }
     }
 }
 
+void applyNormalMove(Board *board, uint16_t move, Undo *undo) {
+
+    // Dispatch once to a version specialised for the side to move
+    if (board->turn == WHITE)
+        applyNormal(board, move, undo, WHITE);
+    else
+        applyNormal(board, move, undo, BLACK);
+}
+
 void applyCastleMove(Board *board, uint16_t move, Undo *undo) {
 
     const int from = MoveFrom(move);
@@ -212,8 +267,12 @@ void applyCastleMove(Board *board, uint16_t move, Undo *undo) {
     board->squares[to]    = fromPiece;
     board->squares[rTo]   = rFromPiece;
 
-    board->castleRooks &= board->castleMasks[from];
-    updateCastleZobrist(board, undo->castleRooks, board->castleRooks);
+    if (board->nnue != NULL) {
+        nnueMovePiece(board, fromPiece, from, to);
+        nnueMovePiece(board, rFromPiece, rFrom, rTo);
+    }
+
+    updateCastleRights(board, board->turn == WHITE ? RANK_1 : RANK_8);
 
     board->psqtmat += PSQT[fromPiece][to]
                    -  PSQT[fromPiece][from]
@@ -229,37 +288,47 @@ void applyCastleMove(Board *board, uint16_t move, Undo *undo) {
     board->pkhash  ^= ZobristKeys[fromPiece][from]
                    ^  ZobristKeys[fromPiece][to];
 
+    subPKAccumulator(board->pkaccum, fromPiece, from);
+    addPKAccumulator(board->pkaccum, fromPiece, to);
+
     assert(pieceType(fromPiece) == KING);
 
     undo->capturePiece = EMPTY;
 }
 
-void applyEnpassMove(Board *board, uint16_t move, Undo *undo) {
+INLINE void applyEnpass(Board *board, uint16_t move, Undo *undo, const int US) {
 
     const int from = MoveFrom(move);
     const int to = MoveTo(move);
-    const int ep = to - 8 + (board->turn << 4);
+    const int ep = to - 8 + (US << 4);
 
-    const int fromPiece = makePiece(PAWN, board->turn);
-    const int enpassPiece = makePiece(PAWN, !board->turn);
+    const int fromPiece = makePiece(PAWN, US);
+    const int enpassPiece = makePiece(PAWN, !US);
 
     board->halfMoveCounter = 0;
 
-    board->pieces[PAWN]         ^= (1ull << from) ^ (1ull << to);
-    board->colours[board->turn] ^= (1ull << from) ^ (1ull << to);
+    board->pieces[PAWN] ^= (1ull << from) ^ (1ull << to);
+    board->colours[US]  ^= (1ull << from) ^ (1ull << to);
 
-    board->pieces[PAWN]          ^= (1ull << ep);
-    board->colours[!board->turn] ^= (1ull << ep);
+    board->pieces[PAWN] ^= (1ull << ep);
+    board->colours[!US] ^= (1ull << ep);
 
     board->squares[from] = EMPTY;
     board->squares[to]   = fromPiece;
     board->squares[ep]   = EMPTY;
     undo->capturePiece   = enpassPiece;
 
+    if (board->nnue != NULL) {
+        nnueMovePiece(board, fromPiece, from, to);
+        nnueRemovePiece(board, enpassPiece, ep);
+    }
+
     board->psqtmat += PSQT[fromPiece][to]
                    -  PSQT[fromPiece][from]
                    -  PSQT[enpassPiece][ep];
 
+    board->matkey  -= MaterialKeys[enpassPiece][ep];
+
     board->hash    ^= ZobristKeys[fromPiece][from]
                    ^  ZobristKeys[fromPiece][to]
                    ^  ZobristKeys[enpassPiece][ep]
@@ -269,10 +338,23 @@ void applyEnpassMove(Board *board, uint16_t move, Undo *undo) {
                    ^  ZobristKeys[fromPiece][to]
                    ^  ZobristKeys[enpassPiece][ep];
 
+    subPKAccumulator(board->pkaccum, fromPiece, from);
+    addPKAccumulator(board->pkaccum, fromPiece, to);
+    subPKAccumulator(board->pkaccum, enpassPiece, ep);
+
     assert(pieceType(fromPiece) == PAWN);
     assert(pieceType(enpassPiece) == PAWN);
 }
 
+void applyEnpassMove(Board *board, uint16_t move, Undo *undo) {
+
+    // Dispatch once to a version specialised for the side to move
+    if (board->turn == WHITE)
+        applyEnpass(board, move, undo, WHITE);
+    else
+        applyEnpass(board, move, undo, BLACK);
+}
+
 void applyPromotionMove(Board *board, uint16_t move, Undo *undo) {
 
     const int from = MoveFrom(move);
@@ -299,19 +381,29 @@ void applyPromotionMove(Board *board, uint16_t move, Undo *undo) {
     board->squares[to]   = promoPiece;
     undo->capturePiece   = toPiece;
 
-    board->castleRooks &= board->castleMasks[to];
-    updateCastleZobrist(board, undo->castleRooks, board->castleRooks);
+    if (board->nnue != NULL) {
+        nnueRemovePiece(board, fromPiece, from);
+        nnueAddPiece(board, promoPiece, to);
+        if (toPiece != EMPTY) nnueRemovePiece(board, toPiece, to);
+    }
+
+    updateCastleRights(board, 1ull << to);
 
     board->psqtmat += PSQT[promoPiece][to]
                    -  PSQT[fromPiece][from]
                    -  PSQT[toPiece][to];
 
+    board->matkey  += MaterialKeys[promoPiece][to]
+                   -  MaterialKeys[fromPiece][from]
+                   -  MaterialKeys[toPiece][to];
+
     board->hash    ^= ZobristKeys[fromPiece][from]
                    ^  ZobristKeys[promoPiece][to]
                    ^  ZobristKeys[toPiece][to]
                    ^  ZobristTurnKey;
 
     board->pkhash  ^= ZobristKeys[fromPiece][from];
+    subPKAccumulator(board->pkaccum, fromPiece, from);
 
     assert(pieceType(fromPiece) == PAWN);
     assert(pieceType(toPiece) != PAWN);
@@ -323,11 +415,13 @@ void applyNullMove(Board *board, Undo *undo) {
     // Save information which is hard to recompute
     // Some information is certain to stay the same
     undo->hash            = board->hash;
+    undo->pinned          = board->pinned;
     undo->epSquare        = board->epSquare;
     undo->halfMoveCounter = board->halfMoveCounter++;
 
     // NULL moves simply swap the turn only
     board->turn = !board->turn;
+    board->pinned = PINNED_UNKNOWN;
     board->history[board->numMoves++] = board->hash;
     board->fullMoveCounter++;
 
@@ -348,33 +442,19 @@ void revert(Thread *thread, Board *board, uint16_t move) {
         revertMove(board, move, &thread->undoStack[--thread->height]);
 }
 
-void revertMove(Board *board, uint16_t move, Undo *undo) {
+INLINE void revertPieces(Board *board, uint16_t move, Undo *undo, const int US) {
 
     const int to = MoveTo(move);
     const int from = MoveFrom(move);
 
-    // Revert information which is hard to recompute
-    board->hash            = undo->hash;
-    board->pkhash          = undo->pkhash;
-    board->kingAttackers   = undo->kingAttackers;
-    board->castleRooks     = undo->castleRooks;
-    board->epSquare        = undo->epSquare;
-    board->halfMoveCounter = undo->halfMoveCounter;
-    board->psqtmat         = undo->psqtmat;
-
-    // Swap turns and update the history index
-    board->turn = !board->turn;
-    board->numMoves--;
-    board->fullMoveCounter--;
-
     if (MoveType(move) == NORMAL_MOVE) {
 
         const int fromType = pieceType(board->squares[to]);
         const int toType = pieceType(undo->capturePiece);
         const int toColour = pieceColour(undo->capturePiece);
 
-        board->pieces[fromType]     ^= (1ull << from) ^ (1ull << to);
-        board->colours[board->turn] ^= (1ull << from) ^ (1ull << to);
+        board->pieces[fromType] ^= (1ull << from) ^ (1ull << to);
+        board->colours[US]      ^= (1ull << from) ^ (1ull << to);
 
         board->pieces[toType]    ^= (1ull << to);
         board->colours[toColour] ^= (1ull << to);
@@ -389,17 +469,17 @@ void revertMove(Board *board, uint16_t move, Undo *undo) {
         const int rTo = castleRookTo(from, rFrom);
         const int _to = castleKingTo(from, rFrom);
 
-        board->pieces[KING]         ^= (1ull << from) ^ (1ull << _to);
-        board->colours[board->turn] ^= (1ull << from) ^ (1ull << _to);
+        board->pieces[KING] ^= (1ull << from) ^ (1ull << _to);
+        board->colours[US]  ^= (1ull << from) ^ (1ull << _to);
 
-        board->pieces[ROOK]         ^= (1ull << rFrom) ^ (1ull << rTo);
-        board->colours[board->turn] ^= (1ull << rFrom) ^ (1ull << rTo);
+        board->pieces[ROOK] ^= (1ull << rFrom) ^ (1ull << rTo);
+        board->colours[US]  ^= (1ull << rFrom) ^ (1ull << rTo);
 
         board->squares[_to] = EMPTY;
         board->squares[rTo] = EMPTY;
 
-        board->squares[from] = makePiece(KING, board->turn);
-        board->squares[rFrom] = makePiece(ROOK, board->turn);
+        board->squares[from] = makePiece(KING, US);
+        board->squares[rFrom] = makePiece(ROOK, US);
     }
 
     else if (MoveType(move) == PROMOTION_MOVE) {
@@ -408,14 +488,14 @@ void revertMove(Board *board, uint16_t move, Undo *undo) {
         const int toColour = pieceColour(undo->capturePiece);
         const int promotype = MovePromoPiece(move);
 
-        board->pieces[PAWN]         ^= (1ull << from);
-        board->pieces[promotype]    ^= (1ull << to);
-        board->colours[board->turn] ^= (1ull << from) ^ (1ull << to);
+        board->pieces[PAWN]      ^= (1ull << from);
+        board->pieces[promotype] ^= (1ull << to);
+        board->colours[US]       ^= (1ull << from) ^ (1ull << to);
 
         board->pieces[toType]    ^= (1ull << to);
         board->colours[toColour] ^= (1ull << to);
 
-        board->squares[from] = makePiece(PAWN, board->turn);
+        board->squares[from] = makePiece(PAWN, US);
         board->squares[to] = undo->capturePiece;
     }
 
@@ -423,13 +503,13 @@ void revertMove(Board *board, uint16_t move, Undo *undo) {
 
         assert(MoveType(move) == ENPASS_MOVE);
 
-        const int ep = to - 8 + (board->turn << 4);
+        const int ep = to - 8 + (US << 4);
 
-        board->pieces[PAWN]         ^= (1ull << from) ^ (1ull << to);
-        board->colours[board->turn] ^= (1ull << from) ^ (1ull << to);
+        board->pieces[PAWN] ^= (1ull << from) ^ (1ull << to);
+        board->colours[US]  ^= (1ull << from) ^ (1ull << to);
 
-        board->pieces[PAWN]          ^= (1ull << ep);
-        board->colours[!board->turn] ^= (1ull << ep);
+        board->pieces[PAWN] ^= (1ull << ep);
+        board->colours[!US] ^= (1ull << ep);
 
         board->squares[from] = board->squares[to];
         board->squares[to] = EMPTY;
@@ -437,10 +517,57 @@ void revertMove(Board *board, uint16_t move, Undo *undo) {
     }
 }
 
+void revertMove(Board *board, uint16_t move, Undo *undo) {
+
+#ifdef USE_COPY_MAKE
+
+    // The copy restores everything, including the NNUE Accumulator
+    // pointer and the Attack Maps. The history entry is left stale
+    memcpy(board, undo->board, BOARD_HOT_SIZE);
+    (void) move;
+
+#else
+
+    // Revert information which is hard to recompute
+    board->hash            = undo->hash;
+    board->pkhash          = undo->pkhash;
+    board->matkey          = undo->matkey;
+    board->kingAttackers   = undo->kingAttackers;
+    board->pinned          = undo->pinned;
+    board->castleRooks     = undo->castleRooks;
+    board->epSquare        = undo->epSquare;
+    board->halfMoveCounter = undo->halfMoveCounter;
+    board->psqtmat         = undo->psqtmat;
+    memcpy(board->pkaccum, undo->pkaccum, sizeof(board->pkaccum));
+
+    // Swap turns and update the history index
+    board->turn = !board->turn;
+    board->numMoves--;
+    board->fullMoveCounter--;
+
+    // Return to the parent's NNUE Accumulator
+    if (board->nnue != NULL)
+        nnuePop(board);
+
+    // Dispatch once to a version specialised for the side which moved
+    if (board->turn == WHITE)
+        revertPieces(board, move, undo, WHITE);
+    else
+        revertPieces(board, move, undo, BLACK);
+
+    // Recompute the attacks of any pieces affected by the move
+#ifdef USE_ATTACK_MAPS
+    updateAttackMap(board, attackMapChanges(move));
+#endif
+
+#endif
+}
+
 void revertNullMove(Board *board, Undo *undo) {
 
     // Revert information which is hard to recompute
     board->hash            = undo->hash;
+    board->pinned          = undo->pinned;
     board->epSquare        = undo->epSquare;
     board->halfMoveCounter = undo->halfMoveCounter;
 
@@ -552,6 +679,60 @@ int moveWasLegal(Board *board) {
     return !squareIsAttacked(board, !board->turn, sq);
 }
 
+int moveIsLegal(Board *board, uint16_t move) {
+
+    // Determine if a pseudo legal move would leave our King safe, without
+    // applying it, by using the checkers and the pieces pinned to our King
+
+    const int from = MoveFrom(move), to = MoveTo(move);
+
+    uint64_t friendly = board->colours[ board->turn];
+    uint64_t enemy    = board->colours[!board->turn];
+    uint64_t occupied = friendly | enemy;
+
+    int kingsq = getlsb(friendly & board->pieces[KING]);
+
+    // Castles were checked for passing through attacks when generated,
+    // so only the King's destination remains, once both pieces have moved
+    if (MoveType(move) == CASTLE_MOVE) {
+        const int kingTo = castleKingTo(from, to), rookTo = castleRookTo(from, to);
+        occupied ^= (1ull << from) ^ (1ull << to);
+        occupied |= (1ull << kingTo) | (1ull << rookTo);
+        return !squareIsAttackedThrough(board, board->turn, kingTo, occupied);
+    }
+
+    // King moves are legal when the destination is safe with the King removed,
+    // so that the King may not step backwards along the ray of a checking slider
+    if (from == kingsq)
+        return !squareIsAttackedThrough(board, board->turn, to, occupied ^ (1ull << from));
+
+    // Only a King move can escape from a double check
+    if (several(board->kingAttackers))
+        return 0;
+
+    // Enpass removes two pieces from the board, which can expose our King
+    // along a rank, so look for any attack after the capture is made
+    if (MoveType(move) == ENPASS_MOVE) {
+        const int capsq = to ^ 8;
+        occupied ^= (1ull << from) ^ (1ull << capsq) ^ (1ull << to);
+        return !(allAttackersToSquare(board, occupied, kingsq) & enemy & ~(1ull << capsq));
+    }
+
+    // A single check must be resolved by capturing or blocking the checker
+    if (   board->kingAttackers
+        && !testBit(board->kingAttackers | bitsBetweenMasks(kingsq, getlsb(board->kingAttackers)), to))
+        return 0;
+
+    // Found once per position, only when a legality check needs them
+    if (board->pinned == PINNED_UNKNOWN)
+        board->pinned = pinnedPieces(board, board->turn);
+
+    // Pinned pieces may only move along the line shared with our King
+    return !testBit(board->pinned, from)
+        || testBit(bitsBetweenMasks(kingsq, to), from)
+        || testBit(bitsBetweenMasks(kingsq, from), to);
+}
+
 int moveIsPseudoLegal(Board *board, uint16_t move) {
 
     int from   = MoveFrom(move);
@@ -686,3 +867,45 @@ void moveToString(uint16_t move, char *str, int chess960) {
         str[5] = '\0';
     }
 }
+
+uint16_t stringToMove(Board *board, char *str) {
+
+    // Decode a move in Long Algebraic Notation, without generating any
+    // moves. The result is only a candidate, which still must be checked
+    // with moveIsPseudoLegal() and for legality before being applied
+
+    static const char PromotionLabels[] = "nbrq";
+
+    for (int i = 0; i < 4; i++)
+        if (str[i] < "a1a1"[i] || str[i] > "h8h8"[i])
+            return NONE_MOVE;
+
+    int from = stringToSquare(&str[0]), to = stringToSquare(&str[2]);
+    int ftype = pieceType(board->squares[from]);
+    uint64_t castles = board->colours[board->turn] & board->castleRooks;
+
+    // Promotions are marked by a trailing n, b, r or q, and
+    // any other trailing character makes for an invalid move
+    if (str[4] != '\0') {
+        const char *promo = strchr(PromotionLabels, str[4]);
+        if (ftype != PAWN || promo == NULL) return NONE_MOVE;
+        return MoveMake(from, to, PROMOTION_MOVE | ((promo - PromotionLabels) << 14));
+    }
+
+    // Enpass is a Pawn moving diagonally onto the enpass square
+    if (ftype == PAWN && to == board->epSquare && fileOf(from) != fileOf(to))
+        return MoveMake(from, to, ENPASS_MOVE);
+
+    // Castles are sent as KxR in FRC, but otherwise only
+    // as the King moving to its final square, like e1g1
+    if (ftype == KING && testBit(castles, to))
+        return MoveMake(from, to, CASTLE_MOVE);
+
+    while (ftype == KING && castles && !board->chess960) {
+        int rook = poplsb(&castles);
+        if (castleKingTo(from, rook) == to)
+            return MoveMake(from, rook, CASTLE_MOVE);
+    }
+
+    return MoveMake(from, to, NORMAL_MOVE);
+}
@@ -59,9 +59,11 @@ int moveIsInRootMoves(Thread *thread, uint16_t move);
 int moveIsTactical(Board *board, uint16_t move);
 int moveEstimatedValue(Board *board, uint16_t move);
 int moveBestCaseValue(Board *board);
+int moveIsLegal(Board *board, uint16_t move);
 int moveIsPseudoLegal(Board *board, uint16_t move);
 int moveWasLegal(Board *board);
 void moveToString(uint16_t move, char *str, int chess960);
+uint16_t stringToMove(Board *board, char *str);
 
 #define MoveFrom(move)         (((move) >> 0) & 63)
 #define MoveTo(move)           (((move) >> 6) & 63)
@@ -92,7 +92,6 @@ uint16_t * buildSliderMoves(SliderFunc F, uint16_t *moves, uint64_t pieces, uint
 
 int genAllLegalMoves(Board *board, uint16_t *moves) {
 
-    Undo undo[1];
     int size = 0, pseudo = 0;
     uint16_t pseudoMoves[MAX_MOVES];
 
@@ -101,28 +100,26 @@ int genAllLegalMoves(Board *board, uint16_t *moves) {
     pseudo += genAllQuietMoves(board, pseudoMoves + pseudo);
 
     // Check each move for legality before copying
-    for (int i = 0; i < pseudo; i++) {
-        applyMove(board, pseudoMoves[i], undo);
-        if (moveWasLegal(board)) moves[size++] = pseudoMoves[i];
-        revertMove(board, pseudoMoves[i], undo);
-    }
+    for (int i = 0; i < pseudo; i++)
+        if (moveIsLegal(board, pseudoMoves[i]))
+            moves[size++] = pseudoMoves[i];
 
     return size;
 }
 
-int genAllNoisyMoves(Board *board, uint16_t *moves) {
+INLINE int genNoisyMoves(Board *board, uint16_t *moves, const int US) {
 
     const uint16_t *start = moves;
 
-    const int Left    = board->turn == WHITE ? -7 : 7;
-    const int Right   = board->turn == WHITE ? -9 : 9;
-    const int Forward = board->turn == WHITE ? -8 : 8;
+    const int Left    = US == WHITE ? -7 : 7;
+    const int Right   = US == WHITE ? -9 : 9;
+    const int Forward = US == WHITE ? -8 : 8;
 
     uint64_t destinations, pawnEnpass, pawnLeft, pawnRight;
     uint64_t pawnPromoForward, pawnPromoLeft, pawnPromoRight;
 
-    uint64_t us       = board->colours[board->turn];
-    uint64_t them     = board->colours[!board->turn];
+    uint64_t us       = board->colours[US];
+    uint64_t them     = board->colours[!US];
     uint64_t occupied = us | them;
 
     uint64_t pawns   = us & (board->pieces[PAWN  ]);
@@ -143,10 +140,10 @@ int genAllNoisyMoves(Board *board, uint16_t *moves) {
     destinations = board->kingAttackers ? board->kingAttackers : them;
 
     // Compute bitboards for each type of Pawn movement
-    pawnEnpass       = pawnEnpassCaptures(pawns, board->epSquare, board->turn);
-    pawnLeft         = pawnLeftAttacks(pawns, them, board->turn);
-    pawnRight        = pawnRightAttacks(pawns, them, board->turn);
-    pawnPromoForward = pawnAdvance(pawns, occupied, board->turn) & PROMOTION_RANKS;
+    pawnEnpass       = pawnEnpassCaptures(pawns, board->epSquare, US);
+    pawnLeft         = pawnLeftAttacks(pawns, them, US);
+    pawnRight        = pawnRightAttacks(pawns, them, US);
+    pawnPromoForward = pawnAdvance(pawns, occupied, US) & PROMOTION_RANKS;
     pawnPromoLeft    = pawnLeft & PROMOTION_RANKS; pawnLeft &= ~PROMOTION_RANKS;
     pawnPromoRight   = pawnRight & PROMOTION_RANKS; pawnRight &= ~PROMOTION_RANKS;
 
@@ -167,18 +164,18 @@ int genAllNoisyMoves(Board *board, uint16_t *moves) {
     return moves - start;
 }
 
-int genAllQuietMoves(Board *board, uint16_t *moves) {
+INLINE int genQuietMoves(Board *board, uint16_t *moves, const int US) {
 
     const uint16_t *start = moves;
 
-    const int Forward = board->turn == WHITE ? -8 : 8;
-    const uint64_t Rank3Relative = board->turn == WHITE ? RANK_3 : RANK_6;
+    const int Forward = US == WHITE ? -8 : 8;
+    const uint64_t Rank3Relative = US == WHITE ? RANK_3 : RANK_6;
 
     int rook, king, rookTo, kingTo, attacked;
     uint64_t destinations, pawnForwardOne, pawnForwardTwo, mask;
 
-    uint64_t us       = board->colours[board->turn];
-    uint64_t occupied = us | board->colours[!board->turn];
+    uint64_t us       = board->colours[US];
+    uint64_t occupied = us | board->colours[!US];
     uint64_t castles  = us & board->castleRooks;
 
     uint64_t pawns   = us & (board->pieces[PAWN  ]);
@@ -200,8 +197,8 @@ int genAllQuietMoves(Board *board, uint16_t *moves) {
                  : bitsBetweenMasks(getlsb(kings), getlsb(board->kingAttackers));
 
     // Compute bitboards for each type of Pawn movement
-    pawnForwardOne = pawnAdvance(pawns, occupied, board->turn) & ~PROMOTION_RANKS;
-    pawnForwardTwo = pawnAdvance(pawnForwardOne & Rank3Relative, occupied, board->turn);
+    pawnForwardOne = pawnAdvance(pawns, occupied, US) & ~PROMOTION_RANKS;
+    pawnForwardTwo = pawnAdvance(pawnForwardOne & Rank3Relative, occupied, US);
 
     // Generate moves for all the pawns, so long as they are quiet
     moves = buildPawnMoves(moves, pawnForwardOne & destinations, Forward);
@@ -231,7 +228,7 @@ int genAllQuietMoves(Board *board, uint16_t *moves) {
         // Castle is illegal if we move through a checking threat
         mask = bitsBetweenMasks(king, kingTo);
         while (mask)
-            if (squareIsAttacked(board, board->turn, poplsb(&mask)))
+            if (squareIsAttacked(board, US, poplsb(&mask)))
                 { attacked = 1; break; }
         if (attacked) continue;
 
@@ -241,3 +238,17 @@ int genAllQuietMoves(Board *board, uint16_t *moves) {
 
     return moves - start;
 }
+
+int genAllNoisyMoves(Board *board, uint16_t *moves) {
+
+    // Dispatch once to a generator specialised for the side to move
+    return board->turn == WHITE ? genNoisyMoves(board, moves, WHITE)
+                                : genNoisyMoves(board, moves, BLACK);
+}
+
+int genAllQuietMoves(Board *board, uint16_t *moves) {
+
+    // Dispatch once to a generator specialised for the side to move
+    return board->turn == WHITE ? genQuietMoves(board, moves, WHITE)
+                                : genQuietMoves(board, moves, BLACK);
+}
@@ -17,6 +17,7 @@
 */
 
 #include <assert.h>
+#include <limits.h>
 
 #include "board.h"
 #include "history.h"
@@ -26,22 +27,70 @@
 #include "types.h"
 #include "thread.h"
 
-static uint16_t popMove(int *size, uint16_t *moves, int *values, int index) {
-    uint16_t popped = moves[index];
-    moves[index] = moves[--*size];
-    values[index] = values[*size];
-    return popped;
+// Most nodes cut off after only a few moves, so the first few moves are
+// found by selection. Past that, the rest of the list is sorted at once.
+// Quiets are sorted only when scoring at least QuietSortLimit
+static const int SelectionsBeforeSort = 6;
+static const int QuietSortLimit = 0;
+
+static void packKeys(MovePicker *mp, int start, int length) {
+
+    // Scores are scaled to make room for the index of the move in the
+    // lower bits, so that ties always go to the move generated first
+
+    for (int i = start; i < start + length; i++)
+        mp->keys[i] = mp->keys[i] * MAX_MOVES + (MAX_MOVES - 1 - i);
+}
+
+static uint16_t keyMove(MovePicker *mp, int key) {
+    return mp->moves[MAX_MOVES - 1 - (key & (MAX_MOVES - 1))];
+}
+
+static int partialInsertionSort(int *keys, int length, int limit) {
+
+    // Keys of at least the limit are sorted to the front, best first,
+    // and everything else is left behind them in no particular order
+
+    int sorted = 0;
+
+    for (int i = 0; i < length; i++) {
+
+        if (keys[i] < limit) continue;
+
+        int key = keys[i];
+        keys[i] = keys[sorted];
+
+        int j = sorted++;
+        for (; j > 0 && keys[j-1] < key; j--)
+            keys[j] = keys[j-1];
+        keys[j] = key;
+    }
+
+    return sorted;
 }
 
-static int getBestMoveIndex(MovePicker *mp, int start, int end) {
+static uint16_t nextBestMove(MovePicker *mp, int start, int end, int limit) {
+
+    // Sort the rest of the list once the selections add up to more than
+    // a sort would cost. Moves before mp->sorted are then already in order
+    if (mp->sorted == start && mp->current - start == SelectionsBeforeSort)
+        mp->sorted = mp->current + partialInsertionSort(mp->keys + mp->current, end - mp->current, limit);
+
+    // Otherwise swap the best of the remaining moves forward
+    if (mp->current >= mp->sorted) {
 
-    int best = start;
+        int best = mp->current;
 
-    for (int i = start + 1; i < end; i++)
-        if (mp->values[i] > mp->values[best])
-            best = i;
+        for (int i = mp->current + 1; i < end; i++)
+            if (mp->keys[i] > mp->keys[best])
+                best = i;
 
-    return best;
+        int temp = mp->keys[best];
+        mp->keys[best] = mp->keys[mp->current];
+        mp->keys[mp->current] = temp;
+    }
+
+    return keyMove(mp, mp->keys[mp->current++]);
 }
 
 
@@ -84,7 +133,7 @@ void initNoisyMovePicker(MovePicker *mp, Thread *thread, int threshold) {
 
 uint16_t selectNextMove(MovePicker *mp, Board *board, int skipQuiets) {
 
-    int best; uint16_t bestMove;
+    uint16_t bestMove;
 
     switch (mp->stage) {
 
@@ -99,11 +148,14 @@ uint16_t selectNextMove(MovePicker *mp, Board *board, int skipQuiets) {
 
         case STAGE_GENERATE_NOISY:
 
-            // Generate and evaluate noisy moves. mp->split sets a break point
-            // to seperate the noisy from the quiet moves, so that we can skip
-            // some of the noisy moves during STAGE_GOOD_NOISY and return later
+            // Generate, evaluate, and sort the noisy moves. mp->split sets a break
+            // point to seperate the noisy from the quiet moves, and those noisy
+            // moves which fail the SEE are gathered at the front for later
             mp->noisySize = mp->split = genAllNoisyMoves(board, mp->moves);
-            getCaptureHistories(mp->thread, mp->moves, mp->values, 0, mp->noisySize);
+            getCaptureHistories(mp->thread, mp->moves, mp->keys, 0, mp->noisySize);
+            packKeys(mp, 0, mp->noisySize);
+
+            mp->current = mp->sorted = mp->badSize = 0;
             mp->stage = STAGE_GOOD_NOISY;
 
             /* fallthrough */
@@ -111,40 +163,32 @@ uint16_t selectNextMove(MovePicker *mp, Board *board, int skipQuiets) {
         case STAGE_GOOD_NOISY:
 
             // Check to see if there are still more noisy moves
-            if (mp->noisySize) {
+            while (mp->current < mp->noisySize) {
 
-                // Grab the next best move index
-                best = getBestMoveIndex(mp, 0, mp->noisySize);
+                bestMove = nextBestMove(mp, 0, mp->noisySize, INT_MIN);
 
-                // Values below zero are flagged as failing an SEE (bad noisy)
-                if (mp->values[best] >= 0) {
-
-                    // Skip moves which fail to beat our SEE margin. We flag those moves
-                    // as failed with the value (-1), and then repeat the selection process
-                    if (!staticExchangeEvaluation(board, mp->moves[best], mp->threshold)) {
-                        mp->values[best] = -1;
-                        return selectNextMove(mp, board, skipQuiets);
-                    }
-
-                    // Reduce effective move list size
-                    bestMove = popMove(&mp->noisySize, mp->moves, mp->values, best);
+                // Skip moves which fail to beat our SEE margin. We save those
+                // moves as bad noisy moves, and then continue the selection
+                if (!staticExchangeEvaluation(board, bestMove, mp->threshold)) {
+                    mp->keys[mp->badSize++] = mp->keys[mp->current-1];
+                    continue;
+                }
 
-                    // Don't play the table move twice
-                    if (bestMove == mp->tableMove)
-                        return selectNextMove(mp, board, skipQuiets);
+                // Don't play the table move twice
+                if (bestMove == mp->tableMove)
+                    continue;
 
-                    // Don't play the refutation moves twice
-                    if (bestMove == mp->killer1) mp->killer1 = NONE_MOVE;
-                    if (bestMove == mp->killer2) mp->killer2 = NONE_MOVE;
-                    if (bestMove == mp->counter) mp->counter = NONE_MOVE;
+                // Don't play the refutation moves twice
+                if (bestMove == mp->killer1) mp->killer1 = NONE_MOVE;
+                if (bestMove == mp->killer2) mp->killer2 = NONE_MOVE;
+                if (bestMove == mp->counter) mp->counter = NONE_MOVE;
 
-                    return bestMove;
-                }
+                return bestMove;
             }
 
             // Jump to bad noisy moves when skipping quiets
             if (skipQuiets) {
-                mp->stage = STAGE_BAD_NOISY;
+                mp->stage = STAGE_BAD_NOISY, mp->current = 0;
                 return selectNextMove(mp, board, skipQuiets);
             }
 
@@ -189,12 +233,16 @@ uint16_t selectNextMove(MovePicker *mp, Board *board, int skipQuiets) {
 
         case STAGE_GENERATE_QUIET:
 
-            // Generate and evaluate all quiet moves when not skipping them
+            // Generate and evaluate all quiet moves when not skipping them,
+            // but only sort those which are likely to be searched at all
+            mp->quietSize = 0;
             if (!skipQuiets) {
                 mp->quietSize = genAllQuietMoves(board, mp->moves + mp->split);
-                getHistoryScores(mp->thread, mp->moves, mp->values, mp->split, mp->quietSize);
+                getHistoryScores(mp->thread, mp->moves, mp->keys, mp->split, mp->quietSize);
+                packKeys(mp, mp->split, mp->quietSize);
             }
 
+            mp->current = mp->sorted = mp->split;
             mp->stage = STAGE_QUIET;
 
             /* fallthrough */
@@ -202,41 +250,39 @@ uint16_t selectNextMove(MovePicker *mp, Board *board, int skipQuiets) {
         case STAGE_QUIET:
 
             // Check to see if there are still more quiet moves
-            if (!skipQuiets && mp->quietSize) {
+            while (!skipQuiets && mp->current < mp->split + mp->quietSize) {
 
-                // Select next best quiet and reduce the effective move list size
-                best = getBestMoveIndex(mp, mp->split, mp->split + mp->quietSize) - mp->split;
-                bestMove = popMove(&mp->quietSize, mp->moves + mp->split, mp->values + mp->split, best);
+                bestMove = nextBestMove(mp, mp->split, mp->split + mp->quietSize, QuietSortLimit * MAX_MOVES);
 
                 // Don't play a move more than once
                 if (   bestMove == mp->tableMove
                     || bestMove == mp->killer1
                     || bestMove == mp->killer2
                     || bestMove == mp->counter)
-                    return selectNextMove(mp, board, skipQuiets);
+                    continue;
 
                 return bestMove;
             }
 
             // Out of quiet moves, only bad quiets remain
-            mp->stage = STAGE_BAD_NOISY;
+            mp->stage = STAGE_BAD_NOISY, mp->current = 0;
 
             /* fallthrough */
 
         case STAGE_BAD_NOISY:
 
-            // Check to see if there are still more noisy moves
-            if (mp->noisySize && mp->type != NOISY_PICKER) {
+            // Check to see if there are still more noisy moves, which were
+            // saved in the same order in which they failed the SEE
+            while (mp->current < mp->badSize && mp->type != NOISY_PICKER) {
 
-                // Reduce effective move list size
-                bestMove = popMove(&mp->noisySize, mp->moves, mp->values, 0);
+                bestMove = keyMove(mp, mp->keys[mp->current++]);
 
                 // Don't play a move more than once
                 if (   bestMove == mp->tableMove
                     || bestMove == mp->killer1
                     || bestMove == mp->killer2
                     || bestMove == mp->counter)
-                    return selectNextMove(mp, board, skipQuiets);
+                    continue;
 
                 return bestMove;
             }
@@ -32,9 +32,9 @@ enum {
 };
 
 struct MovePicker {
-    int split, noisySize, quietSize;
+    int current, sorted, split, noisySize, quietSize, badSize;
     int stage, type, threshold;
-    int values[MAX_MOVES];
+    int keys[MAX_MOVES]; // Score, and the index of the move in the low bits
     uint16_t moves[MAX_MOVES];
     uint16_t tableMove, killer1, killer2, counter;
     Thread *thread;
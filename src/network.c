@@ -22,20 +22,21 @@
 #include <stdlib.h>
 #include <string.h>
 
+#if defined(__AVX2__) || defined(USE_DISPATCH)
+    #include <immintrin.h>
+#endif
+
 #include "bitboards.h"
 #include "board.h"
+#include "cpu.h"
 #include "evaluate.h"
 #include "network.h"
 #include "thread.h"
 #include "types.h"
+#include "weights.h"
 
 PKNetwork PKNN;
 
-static char *PKWeights[] = {
-    #include "weights/pknet_224x32x2.net"
-    ""
-};
-
 static int computePKNetworkIndex(int colour, int piece, int sq) {
     return (64 + 48) * colour
          + (48 * (piece == KING))
@@ -43,78 +44,130 @@ static int computePKNetworkIndex(int colour, int piece, int sq) {
 }
 
 
-void initPKNetwork() {
+int initPKNetwork() {
 
-    for (int i = 0; i < PKNETWORK_LAYER1; i++) {
+    PKNN.inputWeights  = weightsSection("pk.inputWeights",
+        sizeof(int16_t) * PKNETWORK_INPUTS * PKNETWORK_LAYER1);
 
-        char weights[strlen(PKWeights[i]) + 1];
-        strcpy(weights, PKWeights[i]);
-        strtok(weights, " ");
+    PKNN.inputBiases   = weightsSection("pk.inputBiases",
+        sizeof(int16_t) * PKNETWORK_LAYER1);
 
-        for (int j = 0; j < PKNETWORK_INPUTS; j++)
-            PKNN.inputWeights[j][i] = atof(strtok(NULL, " "));
-        PKNN.inputBiases[i] = atof(strtok(NULL, " "));
-    }
+    PKNN.layer1Weights = weightsSection("pk.layer1Weights",
+        sizeof(int16_t) * PKNETWORK_OUTPUTS * PKNETWORK_LAYER1);
 
-    for (int i = 0; i < PKNETWORK_OUTPUTS; i++) {
+    PKNN.layer1Biases  = weightsSection("pk.layer1Biases",
+        sizeof(int32_t) * PKNETWORK_OUTPUTS);
+
+    return PKNN.inputWeights && PKNN.inputBiases
+        && PKNN.layer1Weights && PKNN.layer1Biases;
+}
+
+#if defined(__AVX2__) || defined(USE_DISPATCH)
+
+#pragma GCC push_options
+#pragma GCC target("avx2")
+
+static void computePKOutputsAVX2(const int16_t *pkaccum, int32_t *outputs) {
+
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i *accum = (const __m256i *) pkaccum;
+    const __m256i *weights = (const __m256i *) PKNN.layer1Weights;
+
+    __m256i neurons0 = _mm256_max_epi16(_mm256_loadu_si256(&accum[0]), zero);
+    __m256i neurons1 = _mm256_max_epi16(_mm256_loadu_si256(&accum[1]), zero);
+
+    __m256i sumMG = _mm256_add_epi32(_mm256_madd_epi16(neurons0, weights[0]),
+                                     _mm256_madd_epi16(neurons1, weights[1]));
+    __m256i sumEG = _mm256_add_epi32(_mm256_madd_epi16(neurons0, weights[2]),
+                                     _mm256_madd_epi16(neurons1, weights[3]));
+
+    // Reduce both sums at once, leaving MG in lane 0 and EG in lane 1
+    __m256i paired  = _mm256_hadd_epi32(sumMG, sumEG);
+    __m128i reduced = _mm_add_epi32(_mm256_castsi256_si128(paired), _mm256_extracti128_si256(paired, 1));
+    reduced = _mm_hadd_epi32(reduced, reduced);
+
+    outputs[MG] = PKNN.layer1Biases[MG] + _mm_extract_epi32(reduced, 0);
+    outputs[EG] = PKNN.layer1Biases[EG] + _mm_extract_epi32(reduced, 1);
+}
+
+#pragma GCC pop_options
+
+#endif
+
+#if !defined(__AVX2__)
 
-        char weights[strlen(PKWeights[i + PKNETWORK_LAYER1]) + 1];
-        strcpy(weights, PKWeights[i + PKNETWORK_LAYER1]);
-        strtok(weights, " ");
+static void computePKOutputsGeneric(const int16_t *pkaccum, int32_t *outputs) {
 
+    for (int i = 0; i < PKNETWORK_OUTPUTS; i++) {
+        outputs[i] = PKNN.layer1Biases[i];
         for (int j = 0; j < PKNETWORK_LAYER1; j++)
-            PKNN.layer1Weights[i][j] = atof(strtok(NULL, " "));
-        PKNN.layer1Biases[i] = atof(strtok(NULL, " "));
+            outputs[i] += MAX(0, pkaccum[j]) * PKNN.layer1Weights[i][j];
     }
 }
 
+#endif
+
 int computePKNetwork(Board *board) {
 
-    uint64_t pawns = board->pieces[PAWN];
-    uint64_t kings = board->pieces[KING];
-    uint64_t black = board->colours[BLACK];
+    const int outputScale = PKNETWORK_INPUT_SCALE * PKNETWORK_LAYER1_SCALE;
+
+    int32_t outputNeurons[PKNETWORK_OUTPUTS];
+
+#ifndef NDEBUG
+    // The incremental updates must agree exactly with a full refresh
+    int16_t reference[PKNETWORK_LAYER1];
+    refreshPKAccumulator(board, reference);
+    assert(!memcmp(reference, board->pkaccum, sizeof(reference)));
+#endif
+
+    // Layer 1 is maintained incrementally in board->pkaccum, updated only
+    // when a Pawn or King moves. Apply a ReLU to it, and then compute the
+    // Output Layer with 32-bit sums. We do not apply a ReLU to the Inputs,
+    // since we already know that they are all zeros or ones
+
+#if defined(__AVX2__)
+    computePKOutputsAVX2(board->pkaccum, outputNeurons);
+#elif defined(USE_DISPATCH)
+    if (CPUSimd == SIMD_AVX2)
+        computePKOutputsAVX2(board->pkaccum, outputNeurons);
+    else
+        computePKOutputsGeneric(board->pkaccum, outputNeurons);
+#else
+    computePKOutputsGeneric(board->pkaccum, outputNeurons);
+#endif
 
-    float layer1Neurons[PKNETWORK_LAYER1];
-    float outputNeurons[PKNETWORK_OUTPUTS];
+    assert(PKNETWORK_OUTPUTS == PHASE_NB);
+    return MakeScore(outputNeurons[MG] / outputScale, outputNeurons[EG] / outputScale);
+}
 
-    // Layer 1: Compute the values in the hidden Neurons of Layer 1
-    // by looping over the Kings and Pawns bitboards, and applying
-    // the weight which corresponds to each piece. We break the Kings
-    // into two nearly duplicate steps, in order to more efficiently
-    // set and update the Layer 1 Neurons initially
+void resetPKAccumulator(int16_t *accum) {
+    memcpy(accum, PKNN.inputBiases, sizeof(int16_t) * PKNETWORK_LAYER1);
+}
 
-    { // Do one King first so we can set the Neurons
-        int sq = poplsb(&kings);
-        int idx = computePKNetworkIndex(testBit(black, sq), KING, sq);
-        for (int i = 0; i < PKNETWORK_LAYER1; i++)
-            layer1Neurons[i] = PKNN.inputBiases[i] + PKNN.inputWeights[idx][i];
-    }
+void refreshPKAccumulator(Board *board, int16_t *accum) {
 
-    { // Do the remaining King as we would do normally
-        int sq = poplsb(&kings);
-        int idx = computePKNetworkIndex(testBit(black, sq), KING, sq);
-        for (int i = 0; i < PKNETWORK_LAYER1; i++)
-            layer1Neurons[i] += PKNN.inputWeights[idx][i];
-    }
+    uint64_t pkbits = board->pieces[PAWN] | board->pieces[KING];
 
-    while (pawns) {
-        int sq = poplsb(&pawns);
-        int idx = computePKNetworkIndex(testBit(black, sq), PAWN, sq);
-        for (int i = 0; i < PKNETWORK_LAYER1; i++)
-            layer1Neurons[i] += PKNN.inputWeights[idx][i];
+    resetPKAccumulator(accum);
+
+    while (pkbits) {
+        int sq = poplsb(&pkbits);
+        addPKAccumulator(accum, board->squares[sq], sq);
     }
+}
 
-    // Layer 2: Trivially compute the Output layer. Apply a ReLU here.
-    // We do not apply a ReLU in Layer 1, since we already know that all
-    // of the Inputs in Layer 1 are going to be zeros or ones
+void addPKAccumulator(int16_t *accum, int piece, int sq) {
 
-    for (int i = 0; i < PKNETWORK_OUTPUTS; i++) {
-        outputNeurons[i] = PKNN.layer1Biases[i];
-        for (int j = 0; j < PKNETWORK_LAYER1; j++)
-            if (layer1Neurons[j] >= 0.0)
-                outputNeurons[i] += layer1Neurons[j] * PKNN.layer1Weights[i][j];
-    }
+    const int idx = computePKNetworkIndex(pieceColour(piece), pieceType(piece), sq);
 
-    assert(PKNETWORK_OUTPUTS == PHASE_NB);
-    return MakeScore((int) outputNeurons[MG], (int) outputNeurons[EG]);
+    for (int i = 0; i < PKNETWORK_LAYER1; i++)
+        accum[i] += PKNN.inputWeights[idx][i];
+}
+
+void subPKAccumulator(int16_t *accum, int piece, int sq) {
+
+    const int idx = computePKNetworkIndex(pieceColour(piece), pieceType(piece), sq);
+
+    for (int i = 0; i < PKNETWORK_LAYER1; i++)
+        accum[i] -= PKNN.inputWeights[idx][i];
 }
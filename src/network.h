@@ -20,13 +20,15 @@
 
 #include <stdint.h>
 
-#include "board.h"
 #include "types.h"
 
 #define PKNETWORK_INPUTS  (224)
 #define PKNETWORK_LAYER1  ( 32)
 #define PKNETWORK_OUTPUTS (  2)
 
+#define PKNETWORK_INPUT_SCALE  (128)
+#define PKNETWORK_LAYER1_SCALE ( 64)
+
 typedef struct PKNetwork {
 
     // PKNetworks are of the form [Input, Hidden Layer 1, Output Layer]
@@ -34,16 +36,28 @@ typedef struct PKNetwork {
     // output a Score in CentiPawns for the Midgame and Endgame
 
     // We transpose the Input Weights matrix in order to get better
-    // caching and memory lookups, since when computing we iterate
-    // over only the ~20 Inputs set out of the 224 possible Inputs
+    // caching and memory lookups, since when updating we only touch
+    // the rows of the few Inputs changed by a move
+
+    // Weights are quantized to int16_t by weights/convert.py. The Input Layer is scaled by 128,
+    // keeping the worst case sum of any Neuron well within an int16_t,
+    // and the Output Layer by 64. The Output Biases carry both scales
 
-    ALIGN64 float inputWeights[PKNETWORK_INPUTS][PKNETWORK_LAYER1];
-    ALIGN64 float inputBiases[PKNETWORK_LAYER1];
+    // The Network is used in place from the loaded weights file. Every
+    // section of the file is aligned to 64 bytes, for aligned SIMD loads
 
-    ALIGN64 float layer1Weights[PKNETWORK_OUTPUTS][PKNETWORK_LAYER1];
-    ALIGN64 float layer1Biases[PKNETWORK_OUTPUTS];
+    const int16_t (*inputWeights)[PKNETWORK_LAYER1];
+    const int16_t *inputBiases;
+
+    const int16_t (*layer1Weights)[PKNETWORK_LAYER1];
+    const int32_t *layer1Biases;
 
 } PKNetwork;
 
-void initPKNetwork();
-int computePKNetwork(Board *board);
\ No newline at end of file
+int initPKNetwork();
+int computePKNetwork(Board *board);
+
+void resetPKAccumulator(int16_t *accum);
+void refreshPKAccumulator(Board *board, int16_t *accum);
+void addPKAccumulator(int16_t *accum, int piece, int sq);
+void subPKAccumulator(int16_t *accum, int piece, int sq);
@@ -16,151 +16,186 @@
   along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+
+#include <assert.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
 
+#if defined(__AVX__)
+    #include <immintrin.h>
+#endif
+
 #include "board.h"
 #include "bitboards.h"
 #include "evaluate.h"
 #include "nneval.h"
 #include "types.h"
+#include "weights.h"
 
 NNCache *NNCaches[NN_EG_COUNT];
 EGNetwork EGNetworks[NN_EG_COUNT];
 
-static int evaluateRPvRP(EGNetwork *nn, NNCacheEntry *entry, Board *board);
+// Index of the Network for each material key, or -1 when none applies
+static int8_t EGNetworkIndex[NN_MATERIAL_NB];
+
 
-static char *RPvRP_Weights[] = {
-    #include NN_RPvRP_FILE
-};
+int initEndgameNNs() {
 
+    int success = 1;
+
+    memset(EGNetworkIndex, -1, sizeof(EGNetworkIndex));
+
+    // Allocate an NNCache for each EG network, or clear them
+    // since the cached Neurons may be from an older weights file
+    for (int i = 0; i < NN_EG_COUNT; i++) {
+        if (NNCaches[i] == NULL) NNCaches[i] = calloc(1, sizeof(NNCache));
+        else memset(NNCaches[i], 0, sizeof(NNCache));
+    }
 
-void initEndgameNNs() {
+    success &= initEndgameNN(&EGNetworks[NN_RPvRP], "RPvRP", 1 << ROOK);
 
-    // Allocate an NNCache for each EG network
-    for (int i = 0; i < NN_EG_COUNT; i++)
-        NNCaches[i] = malloc(sizeof(NNCache));
+    // A Network covers every material key made up of only its piece
+    // types, with at least one of them on the board. When Networks
+    // overlap, the first one to be initialized is used
 
-    initEndgameNN(&EGNetworks[NN_RPvRP], RPvRP_Weights, 352);
+    for (int key = 1; key < NN_MATERIAL_NB; key++) {
+
+        const int types = (key | key >> 4) & 0xF;
+
+        for (int i = NN_EG_COUNT - 1; i >= 0; i--)
+            if (!((types << KNIGHT) & ~EGNetworks[i].pieces))
+                EGNetworkIndex[key] = i;
+    }
+
+    return success;
 }
 
-void initEndgameNN(EGNetwork *nn, char *weights[], int inputs) {
+int initEndgameNN(EGNetwork *nn, const char *name, int pieces) {
 
-    // Enough space for the weights and the row ptrs
-    nn->inputWeights = malloc(
-          sizeof(float*) * NN_EG_NEURONS
-        + sizeof(float ) * NN_EG_NEURONS * inputs
-    );
+    static const int Order[PIECE_NB] = { PAWN, KING, KNIGHT, BISHOP, ROOK, QUEEN };
 
-    // Trick to allocate a 2-dimensional array of floats
-    float *ptr = (float *)(nn->inputWeights + NN_EG_NEURONS);
-    for (int i = 0; i < NN_EG_NEURONS; i++)
-        nn->inputWeights[i] = (ptr + inputs * i);
+    char section[48];
+    int offset = 0;
 
-    // Init the weights for the the Input Layer
+    nn->name   = name;
+    nn->pieces = pieces | (1 << PAWN) | (1 << KING);
 
-    for (int i = 0; i < NN_EG_NEURONS; i++) {
+    // Pawns, then Kings, then each piece type the Network uses
+    for (int i = 0; i < PIECE_NB; i++) {
 
-        char line[strlen(weights[i]) + 1];
-        strcpy(line, weights[i]);
-        strtok(line, " ");
+        if (!(nn->pieces & (1 << Order[i])))
+            continue;
 
-        for (int j = 0; j < inputs; j++)
-            nn->inputWeights[i][j] = atof(strtok(NULL, " "));
-        nn->inputBiases[i] = atof(strtok(NULL, " "));
+        for (int colour = WHITE; colour <= BLACK; colour++) {
+            nn->offsets[colour][Order[i]] = offset - 8 * (Order[i] == PAWN);
+            offset += Order[i] == PAWN ? 48 : 64;
+        }
     }
 
-    // Init the weights for the Hidden Layer
+    nn->inputs = offset;
 
-    char line[strlen(weights[NN_EG_NEURONS]) + 1];
-    strcpy(line, weights[NN_EG_NEURONS]);
-    strtok(line, " ");
+    sprintf(section, "eg.%s.inputWeights", name);
+    nn->inputWeights = weightsSection(section, sizeof(float) * NN_EG_NEURONS * nn->inputs);
 
-    for (int i = 0; i < NN_EG_NEURONS; i++)
-        nn->layer1Weights[i] = atof(strtok(NULL, " "));
-    nn->layer1Bias = atof(strtok(NULL, " "));
+    sprintf(section, "eg.%s.inputBiases", name);
+    nn->inputBiases = weightsSection(section, sizeof(float) * NN_EG_NEURONS);
+
+    sprintf(section, "eg.%s.layer1Weights", name);
+    nn->layer1Weights = weightsSection(section, sizeof(float) * NN_EG_NEURONS);
+
+    sprintf(section, "eg.%s.layer1Bias", name);
+    nn->layer1Bias = weightsSection(section, sizeof(float));
+
+    return nn->inputWeights && nn->inputBiases
+        && nn->layer1Weights && nn->layer1Bias;
 }
 
-int evaluateEndgames(Board *board) {
+int endgameMaterialKey(Board *board) {
 
-    uint64_t knights = board->pieces[KNIGHT];
-    uint64_t bishops = board->pieces[BISHOP];
-    uint64_t rooks   = board->pieces[ROOK  ];
-    uint64_t queens  = board->pieces[QUEEN ];
+    // One bit for each non-Pawn, non-King piece type, for each colour
 
-    // If not an endgame (only RP at the moment), return 0
-    if ((knights | bishops | queens) || !rooks)
-        return MakeScore(0, 0);
+    const uint64_t white = board->colours[WHITE];
+    const uint64_t black = board->colours[BLACK];
+
+    int key = 0;
+
+    for (int type = KNIGHT; type <= QUEEN; type++)
+        key |= (!!(board->pieces[type] & white)) << (type - KNIGHT)
+            |  (!!(board->pieces[type] & black)) << (type - KNIGHT + 4);
+
+    return key;
+}
+
+int endgameNetworkIndex(Board *board) {
+    return EGNetworkIndex[endgameMaterialKey(board)];
+}
+
+int evaluateEndgames(Board *board, int egtype) {
 
-    int egtype = NN_RPvRP; // Only NN we have at the moment
+    // No Network exists for this material
+    if (egtype == -1)
+        return MakeScore(0, 0);
 
     NNCacheEntry *entry = &(*NNCaches[egtype])[board->pkhash & NN_CACHE_MASK];
 
     if (entry->key != board->pkhash)
         computeEndgameNeurons(&EGNetworks[egtype], entry, board);
 
-    return evaluateRPvRP(&EGNetworks[egtype], entry, board);
+    return evaluateEndgameNN(&EGNetworks[egtype], entry, board);
 }
 
-void computeEndgameNeurons(EGNetwork *nn, NNCacheEntry *entry, Board *board) {
+static void addEndgameInput(float *neurons, const float *weights) {
 
-    const int PawnIDX[COLOUR_NB] = {  0,  48 };
-    const int KingIDX[COLOUR_NB] = { 96, 160 };
+    // NN_EG_NEURONS floats are exactly one AVX register
+
+#if defined(__AVX__)
+    _mm256_storeu_ps(neurons, _mm256_add_ps(_mm256_loadu_ps(neurons), _mm256_load_ps(weights)));
+#else
+    for (int i = 0; i < NN_EG_NEURONS; i++)
+        neurons[i] += weights[i];
+#endif
+}
+
+static void addEndgameInputs(EGNetwork *nn, float *neurons, Board *board, int type) {
 
-    float neurons[NN_EG_NEURONS];
-    uint64_t pawns = board->pieces[PAWN];
-    uint64_t kings = board->pieces[KING];
     uint64_t black = board->colours[BLACK];
+    uint64_t pieces = board->pieces[type];
 
-    { // Do one King first so we can set the Neuron
-        int sq = poplsb(&kings);
-        int idx = sq + KingIDX[testBit(black, sq)];
-        for (int i = 0; i < NN_EG_NEURONS; i++)
-            neurons[i] = nn->inputBiases[i] + nn->inputWeights[i][idx];
+    while (pieces) {
+        int sq = poplsb(&pieces);
+        int idx = sq + nn->offsets[testBit(black, sq)][type];
+        addEndgameInput(neurons, &nn->inputWeights[idx * NN_EG_NEURONS]);
     }
+}
 
-    {  // Do the King that we did not do first
-        int sq = poplsb(&kings);
-        int idx = sq + KingIDX[testBit(black, sq)];
-        for (int i = 0; i < NN_EG_NEURONS; i++)
-            neurons[i] += nn->inputWeights[i][idx];
-    }
+void computeEndgameNeurons(EGNetwork *nn, NNCacheEntry *entry, Board *board) {
 
-    while (pawns) {
-        int sq = poplsb(&pawns);
-        int idx = (sq - 8) + PawnIDX[testBit(black, sq)];
-        for (int i = 0; i < NN_EG_NEURONS; i++)
-            neurons[i] += nn->inputWeights[i][idx];
-    }
+    float neurons[NN_EG_NEURONS];
+    memcpy(neurons, nn->inputBiases, sizeof(neurons));
+
+    // Both Kings and the Pawns are cached by the Pawn King hash
+    addEndgameInputs(nn, neurons, board, KING);
+    addEndgameInputs(nn, neurons, board, PAWN);
 
     memcpy(entry->neurons, neurons, sizeof(float) * NN_EG_NEURONS);
     entry->key = board->pkhash;
 }
 
-
-static int evaluateRPvRP(EGNetwork *nn, NNCacheEntry *entry, Board *board) {
+int evaluateEndgameNN(EGNetwork *nn, NNCacheEntry *entry, Board *board) {
 
     float neurons[NN_EG_NEURONS], output;
     memcpy(neurons, entry->neurons, sizeof(float) * NN_EG_NEURONS);
 
-    const int RookIDX[COLOUR_NB] = { 224, 288 };
+    for (int type = KNIGHT; type <= QUEEN; type++)
+        if (nn->pieces & (1 << type))
+            addEndgameInputs(nn, neurons, board, type);
 
-    uint64_t rooks = board->pieces[ROOK];
-    uint64_t black = board->colours[BLACK];
-
-    while (rooks) {
-        int sq = poplsb(&rooks);
-        int idx = sq + RookIDX[testBit(black, sq)];
-        for (int i = 0; i < NN_EG_NEURONS; i++)
-            neurons[i] += nn->inputWeights[i][idx];
-    }
-
-    output = nn->layer1Bias;
+    output = *nn->layer1Bias;
     for (int i = 0; i < NN_EG_NEURONS; i++)
         if (neurons[i] >= 0.0)
             output += neurons[i] * nn->layer1Weights[i];
 
     return MakeScore(0, (int) output);
-}
\ No newline at end of file
+}
@@ -16,8 +16,13 @@
   along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+
 #pragma once
 
+#include <stdint.h>
+
+#include "types.h"
+
 #define NN_EG_NEURONS   8
 #define NN_CACHE_SIZE   65536
 #define NN_CACHE_MASK   65535
@@ -25,7 +30,7 @@
 #define NN_RPvRP        0
 #define NN_EG_COUNT     1
 
-#define NN_RPvRP_FILE   "weights/RPvRP.net"
+#define NN_MATERIAL_NB  256
 
 typedef struct NNCacheEntry {
     float neurons[NN_EG_NEURONS];
@@ -35,14 +40,29 @@ typedef struct NNCacheEntry {
 typedef NNCacheEntry NNCache[NN_CACHE_SIZE];
 
 typedef struct EGNetwork {
-    float **inputWeights;
-    float inputBiases[NN_EG_NEURONS];
-    float layer1Weights[NN_EG_NEURONS];
-    float layer1Bias;
+
+    // Each Endgame Network sees both Kings and all Pawns, as well as the
+    // piece types in its pieces mask, with a block of 64 inputs for each
+    // type and colour. Pawns only use 48 inputs. The Input Weights are
+    // stored input-major, so that each input is one contiguous vector,
+    // and are used in place from the loaded weights file
+
+    const char *name;
+    int pieces, inputs;
+    int offsets[COLOUR_NB][PIECE_NB];
+
+    const float *inputWeights;
+    const float *inputBiases;
+    const float *layer1Weights;
+    const float *layer1Bias;
+
 } EGNetwork;
 
-void initEndgameNNs();
-void initEndgameNN(EGNetwork *nn, char *weights[], int inputs);
+int initEndgameNNs();
+int initEndgameNN(EGNetwork *nn, const char *name, int pieces);
 
-int evaluateEndgames(Board *board);
-void computeEndgameNeurons(EGNetwork *nn, NNCacheEntry *entry, Board *board);
\ No newline at end of file
+int endgameMaterialKey(Board *board);
+int endgameNetworkIndex(Board *board);
+int evaluateEndgames(Board *board, int egtype);
+void computeEndgameNeurons(EGNetwork *nn, NNCacheEntry *entry, Board *board);
+int evaluateEndgameNN(EGNetwork *nn, NNCacheEntry *entry, Board *board);
@@ -0,0 +1,189 @@
+/*
+  Ethereal is a UCI chess playing engine authored by Andrew Grant.
+  <https://github.com/AndyGrant/Ethereal>     <andrew@grantnet.us>
+
+  Ethereal is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Ethereal is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__AVX2__) || defined(__SSE4_1__) || defined(USE_DISPATCH)
+    #include <immintrin.h>
+#endif
+
+#include "bitboards.h"
+#include "board.h"
+#include "cpu.h"
+#include "nnue.h"
+#include "types.h"
+
+int UseNNUE; // Global for the UseNNUE UCI option
+static int NNUELoaded;
+
+static int16_t *InputWeights; // [NNUE_INPUTS][NNUE_HIDDEN], too large to be static
+static ALIGN64 int16_t InputBiases[NNUE_HIDDEN];
+
+static ALIGN64 int8_t  L1Weights[NNUE_LAYER1][2 * NNUE_HIDDEN];
+static ALIGN64 int32_t L1Biases[NNUE_LAYER1];
+
+static ALIGN64 int8_t  L2Weights[NNUE_LAYER2][NNUE_LAYER1];
+static ALIGN64 int32_t L2Biases[NNUE_LAYER2];
+
+static ALIGN64 int8_t  OutWeights[NNUE_LAYER2];
+static int32_t OutBias;
+
+static int nnueIndex(int perspective, int ksq, int piece, int sq) {
+
+    // HalfKP views the board from each side, rotating the board for Black.
+    // Pieces are split into our own and the enemy's, and Kings are only
+    // used to select one of the 64 blocks of Piece-Square inputs
+
+    const int orient = perspective == WHITE ? 0 : 63;
+
+    return 1 + 128 * pieceType(piece)
+         + 64 * (pieceColour(piece) != perspective)
+         + (sq ^ orient) + NNUE_KPP_INPUTS * (ksq ^ orient);
+}
+
+#if defined(USE_DISPATCH)
+
+    // Compile the kernels for each target, selecting one per evaluation
+
+    #pragma GCC push_options
+    #pragma GCC target("avx2")
+    #define SIMD(kernel) kernel##AVX2
+    #include "nnuesimd.h"
+    #undef SIMD
+    #pragma GCC pop_options
+
+    #pragma GCC push_options
+    #pragma GCC target("sse4.1")
+    #define SIMD(kernel) kernel##SSE41
+    #include "nnuesimd.h"
+    #undef SIMD
+    #pragma GCC pop_options
+
+    #define SIMD(kernel) kernel##Generic
+    #include "nnuesimd.h"
+    #undef SIMD
+
+#else
+
+    #define SIMD(kernel) kernel
+    #include "nnuesimd.h"
+    #undef SIMD
+
+#endif
+
+static const uint8_t *nnueRead(const uint8_t **cursor, const uint8_t *end, void *dest, size_t bytes) {
+
+    // Copy the next chunk of the file, or return NULL if we ran out
+
+    if (*cursor == NULL || (size_t) (end - *cursor) < bytes)
+        return *cursor = NULL;
+
+    memcpy(dest, *cursor, bytes);
+    return *cursor += bytes;
+}
+
+int initNNUE(const char *path) {
+
+    // Load a HalfKP(Friend)-256x2-32-32-1 Network in the format written by
+    // the Stockfish 12 trainer. We validate the version and the total size,
+    // and leave any previously loaded Network in place on a failure
+
+    FILE *fin = fopen(path, "rb");
+    if (fin == NULL) return 0;
+
+    fseek(fin, 0, SEEK_END);
+    size_t size = ftell(fin);
+    fseek(fin, 0, SEEK_SET);
+
+    uint8_t *data = malloc(size);
+    if (fread(data, 1, size, fin) != size) size = 0;
+    fclose(fin);
+
+    const uint8_t *cursor = data, *end = data + size;
+    uint32_t version, hash, length;
+
+    nnueRead(&cursor, end, &version, sizeof(version));
+    nnueRead(&cursor, end, &hash, sizeof(hash));
+    nnueRead(&cursor, end, &length, sizeof(length));
+
+    if (cursor == NULL || version != NNUE_VERSION || length > size) {
+        free(data); return 0;
+    }
+
+    const size_t remaining = sizeof(uint32_t) + sizeof(InputBiases)
+                           + sizeof(int16_t) * NNUE_INPUTS * NNUE_HIDDEN
+                           + sizeof(uint32_t) + sizeof(L1Biases) + sizeof(L1Weights)
+                           + sizeof(L2Biases) + sizeof(L2Weights)
+                           + sizeof(OutBias) + sizeof(OutWeights);
+
+    // Skip the description, and expect exactly the remaining parameters
+
+    if ((size_t) (end - cursor) != length + remaining) {
+        free(data); return 0;
+    }
+
+    cursor += length;
+
+    if (InputWeights == NULL)
+        InputWeights = aligned_alloc(64, sizeof(int16_t) * NNUE_INPUTS * NNUE_HIDDEN);
+
+    nnueRead(&cursor, end, &hash, sizeof(hash));
+    nnueRead(&cursor, end, InputBiases, sizeof(InputBiases));
+    nnueRead(&cursor, end, InputWeights, sizeof(int16_t) * NNUE_INPUTS * NNUE_HIDDEN);
+
+    nnueRead(&cursor, end, &hash, sizeof(hash));
+    nnueRead(&cursor, end, L1Biases, sizeof(L1Biases));
+    nnueRead(&cursor, end, L1Weights, sizeof(L1Weights));
+    nnueRead(&cursor, end, L2Biases, sizeof(L2Biases));
+    nnueRead(&cursor, end, L2Weights, sizeof(L2Weights));
+    nnueRead(&cursor, end, &OutBias, sizeof(OutBias));
+    nnueRead(&cursor, end, OutWeights, sizeof(OutWeights));
+
+    free(data);
+    return NNUELoaded = 1;
+}
+
+int nnueEnabled() {
+    return UseNNUE && NNUELoaded;
+}
+
+void nnueResetAccumulator(NNUEAccumulator *accum) {
+    accum->changes = NNUE_ROOT;
+    accum->accurate[WHITE] = accum->accurate[BLACK] = 0;
+}
+
+int evaluateNNUE(Board *board) {
+
+    NNUEAccumulator scratch, *accum = board->nnue;
+
+    // Boards outside of a search have no Accumulator stack
+    if (accum == NULL)
+        nnueResetAccumulator(accum = &scratch);
+
+#if defined(USE_DISPATCH)
+    if (CPUSimd == SIMD_AVX2 ) return nnuePropagateAVX2(board, accum);
+    if (CPUSimd == SIMD_SSE41) return nnuePropagateSSE41(board, accum);
+    return nnuePropagateGeneric(board, accum);
+#else
+    return nnuePropagate(board, accum);
+#endif
+}
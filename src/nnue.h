@@ -0,0 +1,90 @@
+/*
+  Ethereal is a UCI chess playing engine authored by Andrew Grant.
+  <https://github.com/AndyGrant/Ethereal>     <andrew@grantnet.us>
+
+  Ethereal is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Ethereal is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <stdint.h>
+
+#include "board.h"
+#include "types.h"
+
+enum {
+    NNUE_KPP_INPUTS = 641,                    // 1 + 10 Piece-Square blocks
+    NNUE_INPUTS     = 64 * NNUE_KPP_INPUTS,   // HalfKP, one block per King Square
+    NNUE_HIDDEN     = 256,
+    NNUE_LAYER1     = 32,
+    NNUE_LAYER2     = 32,
+};
+
+enum {
+    NNUE_VERSION    = 0x7AF32F16, // Header used by Stockfish 12 style networks
+    NNUE_SHIFT      = 6,          // Weights of the dense layers are scaled by 64
+    NNUE_FV_SCALE   = 16,         // Output units per internal unit of the trainer
+    NNUE_PAWN_VALUE = 208,        // A Pawn in the trainer's internal units
+    NNUE_ROOT       = -1,         // Marks an Accumulator with no parent
+};
+
+typedef struct NNUEDelta {
+    int piece, from, to;
+} NNUEDelta;
+
+struct NNUEAccumulator {
+
+    // Each Accumulator holds the first layer of the Network for both
+    // perspectives. Accumulators are only updated once evaluated, so we
+    // record the (at most three) piece changes made by the move leading
+    // to this position, and the colours whose values are already known
+
+    ALIGN64 int16_t values[COLOUR_NB][NNUE_HIDDEN];
+    NNUEDelta deltas[3];
+    int changes, accurate[COLOUR_NB];
+};
+
+extern int UseNNUE;
+
+int initNNUE(const char *path);
+int nnueEnabled();
+void nnueResetAccumulator(NNUEAccumulator *accum);
+int evaluateNNUE(Board *board);
+
+static inline void nnuePush(Board *board) {
+
+    // Called by applyMove(). NULL moves do not change the pieces, and
+    // the Accumulator is ordered by the side to move only when evaluated,
+    // so those never push and share the Accumulator of their parent
+
+    NNUEAccumulator *accum = ++board->nnue;
+    accum->changes = accum->accurate[WHITE] = accum->accurate[BLACK] = 0;
+}
+
+static inline void nnuePop(Board *board) {
+    board->nnue--;
+}
+
+static inline void nnueMovePiece(Board *board, int piece, int from, int to) {
+    board->nnue->deltas[board->nnue->changes++] = (NNUEDelta) { piece, from, to };
+}
+
+static inline void nnueAddPiece(Board *board, int piece, int sq) {
+    board->nnue->deltas[board->nnue->changes++] = (NNUEDelta) { piece, SQUARE_NB, sq };
+}
+
+static inline void nnueRemovePiece(Board *board, int piece, int sq) {
+    board->nnue->deltas[board->nnue->changes++] = (NNUEDelta) { piece, sq, SQUARE_NB };
+}
@@ -0,0 +1,275 @@
+/*
+  Ethereal is a UCI chess playing engine authored by Andrew Grant.
+  <https://github.com/AndyGrant/Ethereal>     <andrew@grantnet.us>
+
+  Ethereal is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Ethereal is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+// Included by nnue.c once per SIMD target. Each kernel's name is wrapped
+// with SIMD(), which appends the target when dispatching at runtime, and
+// the __AVX2__ and __SSE4_1__ macros follow the enclosing target pragma.
+// There is no #pragma once, by design
+
+static void SIMD(nnueAddInput)(int16_t *values, int index) {
+
+    // Thread Pools are not allocated with 64 byte alignment, so the
+    // Accumulators themselves are accessed with unaligned loads
+
+    const int16_t *row = &InputWeights[index * NNUE_HIDDEN];
+
+#if defined(__AVX2__)
+    for (int i = 0; i < NNUE_HIDDEN; i += 16) {
+        __m256i *vals = (__m256i *) &values[i];
+        _mm256_storeu_si256(vals, _mm256_add_epi16(_mm256_loadu_si256(vals),
+                            _mm256_load_si256((const __m256i *) &row[i])));
+    }
+#elif defined(__SSE4_1__)
+    for (int i = 0; i < NNUE_HIDDEN; i += 8) {
+        __m128i *vals = (__m128i *) &values[i];
+        _mm_storeu_si128(vals, _mm_add_epi16(_mm_loadu_si128(vals),
+                         _mm_load_si128((const __m128i *) &row[i])));
+    }
+#else
+    for (int i = 0; i < NNUE_HIDDEN; i++)
+        values[i] += row[i];
+#endif
+}
+
+static void SIMD(nnueSubInput)(int16_t *values, int index) {
+
+    const int16_t *row = &InputWeights[index * NNUE_HIDDEN];
+
+#if defined(__AVX2__)
+    for (int i = 0; i < NNUE_HIDDEN; i += 16) {
+        __m256i *vals = (__m256i *) &values[i];
+        _mm256_storeu_si256(vals, _mm256_sub_epi16(_mm256_loadu_si256(vals),
+                            _mm256_load_si256((const __m256i *) &row[i])));
+    }
+#elif defined(__SSE4_1__)
+    for (int i = 0; i < NNUE_HIDDEN; i += 8) {
+        __m128i *vals = (__m128i *) &values[i];
+        _mm_storeu_si128(vals, _mm_sub_epi16(_mm_loadu_si128(vals),
+                         _mm_load_si128((const __m128i *) &row[i])));
+    }
+#else
+    for (int i = 0; i < NNUE_HIDDEN; i++)
+        values[i] -= row[i];
+#endif
+}
+
+static void SIMD(nnueRefreshAccumulator)(NNUEAccumulator *accum, Board *board, int colour) {
+
+    // Rebuild one perspective from the biases and every non-King piece
+
+    uint64_t pieces = board->colours[WHITE] | board->colours[BLACK];
+    const int ksq = getlsb(board->pieces[KING] & board->colours[colour]);
+
+    pieces &= ~board->pieces[KING];
+    memcpy(accum->values[colour], InputBiases, sizeof(InputBiases));
+
+    while (pieces) {
+        int sq = poplsb(&pieces);
+        SIMD(nnueAddInput)(accum->values[colour], nnueIndex(colour, ksq, board->squares[sq], sq));
+    }
+
+    accum->accurate[colour] = 1;
+}
+
+static void SIMD(nnueUpdateAccumulator)(NNUEAccumulator *accum, Board *board, int colour) {
+
+    NNUEAccumulator *start = accum;
+    const int ksq = getlsb(board->pieces[KING] & board->colours[colour]);
+
+    // Find the last accurate Accumulator for this perspective. If we reach
+    // the root, or a move of our King, then the inputs are from another
+    // King square and a full refresh is cheaper than replaying the moves
+
+    while (!start->accurate[colour]) {
+
+        if (start->changes == NNUE_ROOT)
+            return SIMD(nnueRefreshAccumulator)(accum, board, colour);
+
+        for (int i = 0; i < start->changes; i++)
+            if (start->deltas[i].piece == makePiece(KING, colour))
+                return SIMD(nnueRefreshAccumulator)(accum, board, colour);
+
+        start--;
+    }
+
+    // Replay each move's changes, marking each Accumulator as we go so that
+    // sibling nodes may start from the same ancestors without a replay
+
+    for (NNUEAccumulator *next = start + 1; next <= accum; start = next++) {
+
+        memcpy(next->values[colour], start->values[colour], sizeof(start->values[colour]));
+
+        for (int i = 0; i < next->changes; i++) {
+
+            const NNUEDelta *delta = &next->deltas[i];
+
+            if (pieceType(delta->piece) == KING)
+                continue;
+
+            if (delta->from != SQUARE_NB)
+                SIMD(nnueSubInput)(next->values[colour], nnueIndex(colour, ksq, delta->piece, delta->from));
+
+            if (delta->to != SQUARE_NB)
+                SIMD(nnueAddInput)(next->values[colour], nnueIndex(colour, ksq, delta->piece, delta->to));
+        }
+
+        next->accurate[colour] = 1;
+    }
+}
+
+static void SIMD(nnueTransform)(const NNUEAccumulator *accum, int turn, uint8_t *outputs) {
+
+    // Clip both perspectives to [0, 127], with the side to move first
+
+    for (int side = 0; side < COLOUR_NB; side++) {
+
+        const int16_t *values = accum->values[side == 0 ? turn : !turn];
+        uint8_t *out = &outputs[side * NNUE_HIDDEN];
+
+#if defined(__AVX2__)
+        const __m256i zero = _mm256_setzero_si256();
+        for (int i = 0; i < NNUE_HIDDEN; i += 32) {
+            __m256i packed = _mm256_packs_epi16(
+                _mm256_loadu_si256((const __m256i *) &values[i +  0]),
+                _mm256_loadu_si256((const __m256i *) &values[i + 16]));
+            packed = _mm256_permute4x64_epi64(_mm256_max_epi8(packed, zero), 0xD8);
+            _mm256_store_si256((__m256i *) &out[i], packed);
+        }
+#elif defined(__SSE4_1__)
+        const __m128i zero = _mm_setzero_si128();
+        for (int i = 0; i < NNUE_HIDDEN; i += 16) {
+            __m128i packed = _mm_packs_epi16(
+                _mm_loadu_si128((const __m128i *) &values[i + 0]),
+                _mm_loadu_si128((const __m128i *) &values[i + 8]));
+            _mm_store_si128((__m128i *) &out[i], _mm_max_epi8(packed, zero));
+        }
+#else
+        for (int i = 0; i < NNUE_HIDDEN; i++)
+            out[i] = MAX(0, MIN(127, values[i]));
+#endif
+    }
+}
+
+static int32_t SIMD(nnueDot)(const uint8_t *inputs, const int8_t *weights, int length) {
+
+    // Dot product of unsigned 8-bit inputs with signed 8-bit weights. The
+    // SIMD paths pair products into 16-bit lanes, matching the trainer
+
+#if defined(__AVX2__)
+    __m256i sum = _mm256_setzero_si256();
+    const __m256i ones = _mm256_set1_epi16(1);
+
+    for (int i = 0; i < length; i += 32) {
+        __m256i product = _mm256_maddubs_epi16(
+            _mm256_load_si256((const __m256i *) &inputs[i]),
+            _mm256_load_si256((const __m256i *) &weights[i]));
+        sum = _mm256_add_epi32(sum, _mm256_madd_epi16(product, ones));
+    }
+
+    __m128i reduced = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+    reduced = _mm_add_epi32(reduced, _mm_shuffle_epi32(reduced, 0x4E));
+    reduced = _mm_add_epi32(reduced, _mm_shuffle_epi32(reduced, 0xB1));
+    return _mm_cvtsi128_si32(reduced);
+#elif defined(__SSE4_1__)
+    __m128i sum = _mm_setzero_si128();
+    const __m128i ones = _mm_set1_epi16(1);
+
+    for (int i = 0; i < length; i += 16) {
+        __m128i product = _mm_maddubs_epi16(
+            _mm_load_si128((const __m128i *) &inputs[i]),
+            _mm_load_si128((const __m128i *) &weights[i]));
+        sum = _mm_add_epi32(sum, _mm_madd_epi16(product, ones));
+    }
+
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4E));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xB1));
+    return _mm_cvtsi128_si32(sum);
+#else
+    int32_t sum = 0;
+    for (int i = 0; i < length; i++)
+        sum += inputs[i] * weights[i];
+    return sum;
+#endif
+}
+
+static void SIMD(nnueAffineClipped)(const uint8_t *inputs, int length, const int8_t *weights,
+                              const int32_t *biases, uint8_t *outputs, int outlength) {
+
+#if defined(__AVX2__)
+
+    // Compute four neurons at once, sharing the loads of the inputs, and
+    // then reduce all four sums together with a pair of horizontal adds
+
+    const __m256i ones = _mm256_set1_epi16(1);
+
+    for (int i = 0; i < outlength; i += 4) {
+
+        __m256i sums[4] = { _mm256_setzero_si256(), _mm256_setzero_si256(),
+                            _mm256_setzero_si256(), _mm256_setzero_si256() };
+
+        for (int j = 0; j < length; j += 32) {
+            const __m256i input = _mm256_load_si256((const __m256i *) &inputs[j]);
+            for (int k = 0; k < 4; k++) {
+                const __m256i product = _mm256_maddubs_epi16(input,
+                    _mm256_load_si256((const __m256i *) &weights[(i + k) * length + j]));
+                sums[k] = _mm256_add_epi32(sums[k], _mm256_madd_epi16(product, ones));
+            }
+        }
+
+        const __m256i paired = _mm256_hadd_epi32(
+            _mm256_hadd_epi32(sums[0], sums[1]), _mm256_hadd_epi32(sums[2], sums[3]));
+
+        __m128i reduced = _mm_add_epi32(_mm256_castsi256_si128(paired), _mm256_extracti128_si256(paired, 1));
+        reduced = _mm_add_epi32(reduced, _mm_loadu_si128((const __m128i *) &biases[i]));
+        reduced = _mm_srai_epi32(reduced, NNUE_SHIFT);
+
+        // Clip to [0, 127] by saturating twice and dropping negatives
+        reduced = _mm_packs_epi32(reduced, reduced);
+        reduced = _mm_max_epi8(_mm_packs_epi16(reduced, reduced), _mm_setzero_si128());
+        *(int32_t *) &outputs[i] = _mm_cvtsi128_si32(reduced);
+    }
+
+#else
+
+    for (int i = 0; i < outlength; i++) {
+        int32_t sum = biases[i] + SIMD(nnueDot)(inputs, &weights[i * length], length);
+        outputs[i] = MAX(0, MIN(127, sum >> NNUE_SHIFT));
+    }
+
+#endif
+}
+
+static int SIMD(nnuePropagate)(Board *board, NNUEAccumulator *accum) {
+
+    ALIGN64 uint8_t transformed[2 * NNUE_HIDDEN];
+    ALIGN64 uint8_t layer1[NNUE_LAYER1];
+    ALIGN64 uint8_t layer2[NNUE_LAYER2];
+
+    SIMD(nnueUpdateAccumulator)(accum, board, WHITE);
+    SIMD(nnueUpdateAccumulator)(accum, board, BLACK);
+
+    SIMD(nnueTransform)(accum, board->turn, transformed);
+    SIMD(nnueAffineClipped)(transformed, 2 * NNUE_HIDDEN, &L1Weights[0][0], L1Biases, layer1, NNUE_LAYER1);
+    SIMD(nnueAffineClipped)(layer1, NNUE_LAYER1, &L2Weights[0][0], L2Biases, layer2, NNUE_LAYER2);
+
+    int output = OutBias + SIMD(nnueDot)(layer2, OutWeights, NNUE_LAYER2);
+
+    // Convert from the trainer's units, from the side to move's POV
+    return output / NNUE_FV_SCALE * 100 / NNUE_PAWN_VALUE;
+}
@@ -0,0 +1,107 @@
+/*
+  Ethereal is a UCI chess playing engine authored by Andrew Grant.
+  <https://github.com/AndyGrant/Ethereal>     <andrew@grantnet.us>
+
+  Ethereal is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Ethereal is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+#include "bitboards.h"
+#include "cpu.h"
+#include "types.h"
+
+// Pairs only beat the scalar code when both lanes can be counted and
+// weighted in a single instruction, which requires AVX-512 VPOPCNTQ and
+// VPMULLQ. Otherwise the evaluation uses the per colour functions. Builds
+// which dispatch at runtime compile the pairs for AVX-512 regardless, and
+// use them when the CPU reports support via CPUPairs
+
+#if defined(__AVX512VPOPCNTDQ__) && defined(__AVX512VL__) && defined(__AVX512DQ__)
+    #define USE_PAIRS
+    #define PAIRS_AVAILABLE 1
+#elif defined(USE_DISPATCH)
+    #define USE_PAIRS
+    #define PAIRS_AVAILABLE CPUPairs
+#endif
+
+#if defined(USE_PAIRS)
+    #include <immintrin.h>
+#endif
+
+#if defined(USE_DISPATCH)
+    #pragma GCC push_options
+    #pragma GCC target("avx512f,avx512vl,avx512dq,avx512vpopcntdq")
+#endif
+
+// A BitboardPair holds one Bitboard for each colour in a single 128-bit
+// vector, so that both sides of a symmetric evaluation term are computed
+// with one instruction. Black's lane is kept flipped vertically, which
+// makes every colour dependent shift identical for both lanes: both sides'
+// Pawns advance with << 8. Swapping perspectives is then a single reversal
+// of all sixteen bytes. Masks must be given for both lanes with pairFrom()
+
+typedef uint64_t BitboardPair __attribute__((vector_size(16)));
+typedef char BitboardPairBytes __attribute__((vector_size(16)));
+
+static inline BitboardPair pairRelative(BitboardPair pair) {
+    const BitboardPairBytes flip = { 0, 1, 2, 3, 4, 5, 6, 7, 15, 14, 13, 12, 11, 10, 9, 8 };
+    return (BitboardPair) __builtin_shuffle((BitboardPairBytes) pair, flip);
+}
+
+static inline BitboardPair pairFrom(uint64_t white, uint64_t black) {
+    return pairRelative((BitboardPair) { white, black });
+}
+
+static inline BitboardPair pairLoad(const uint64_t bbs[COLOUR_NB]) {
+    BitboardPair pair; memcpy(&pair, bbs, sizeof(pair));
+    return pairRelative(pair);
+}
+
+static inline BitboardPair pairOf(uint64_t bb) {
+    return pairFrom(bb, bb);
+}
+
+static inline BitboardPair pairSwap(BitboardPair pair) {
+    const BitboardPairBytes reverse = { 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0 };
+    return (BitboardPair) __builtin_shuffle((BitboardPairBytes) pair, reverse);
+}
+
+static inline BitboardPair pairPopcount(BitboardPair pair) {
+#if defined(__AVX512VPOPCNTDQ__) && defined(__AVX512VL__)
+    return (BitboardPair) _mm_popcnt_epi64((__m128i) pair);
+#else
+    return (BitboardPair) { popcount(pair[WHITE]), popcount(pair[BLACK]) };
+#endif
+}
+
+static inline int pairDifference(BitboardPair pair) {
+    return (int) (pair[WHITE] - pair[BLACK]);
+}
+
+static inline BitboardPair pairAdvance(BitboardPair pawns, BitboardPair occupied) {
+    return ~occupied & (pawns << 8);
+}
+
+static inline BitboardPair pairAttackSpan(BitboardPair pawns, BitboardPair targets) {
+    return targets & (((pawns << 7) & pairOf(~FILE_H)) | ((pawns << 9) & pairOf(~FILE_A)));
+}
+
+#if defined(USE_DISPATCH)
+    #pragma GCC pop_options
+#endif
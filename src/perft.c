@@ -0,0 +1,195 @@
+/*
+  Ethereal is a UCI chess playing engine authored by Andrew Grant.
+  <https://github.com/AndyGrant/Ethereal>     <andrew@grantnet.us>
+
+  Ethereal is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Ethereal is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "board.h"
+#include "move.h"
+#include "movegen.h"
+#include "perft.h"
+#include "time.h"
+#include "types.h"
+
+typedef struct PerftTable {
+    PerftEntry *entries;
+    uint64_t mask;
+} PerftTable;
+
+typedef struct PerftWorker {
+    Board board;
+    PerftTable *table;
+    uint16_t *moves;
+    uint64_t *counts;
+    int nmoves, depth, *next;
+    pthread_mutex_t *lock;
+} PerftWorker;
+
+static const uint64_t MB = 1ull << 20;
+
+static uint64_t perftKey(Board *board, int depth) {
+    return board->hash ^ (0x9E3779B97F4A7C15ull * depth);
+}
+
+static uint64_t perftSearch(Board *board, int depth, PerftTable *table) {
+
+    Undo undo[1];
+    int size = 0, legal = 0;
+    uint64_t found = 0ull, key = 0ull;
+    uint16_t moves[MAX_MOVES];
+    PerftEntry *entry = NULL;
+
+    if (depth == 0) return 1ull;
+
+    // Subtrees are shared between Threads by key and depth. Entries are
+    // stored as the key XOR'ed with the count, so that an entry torn by
+    // a concurrent store will fail to verify. Depth one is not worth it
+    if (table != NULL && depth > 1) {
+
+        key   = perftKey(board, depth);
+        entry = &table->entries[key & table->mask];
+
+        uint64_t check = entry->check, count = entry->count;
+        if ((check ^ count) == key) return count;
+    }
+
+    // Call genAllNoisyMoves() & genAllQuietMoves()
+    size += genAllNoisyMoves(board, moves);
+    size += genAllQuietMoves(board, moves + size);
+
+    // Count the leaves without applying them, as moveIsLegal() is exact
+    if (depth == 1) {
+        for (int i = 0; i < size; i++)
+            legal += moveIsLegal(board, moves[i]);
+        return legal;
+    }
+
+    // Recurse on all legal moves
+    for (int i = 0; i < size; i++) {
+        if (!moveIsLegal(board, moves[i])) continue;
+        applyMove(board, moves[i], undo);
+        found += perftSearch(board, depth-1, table);
+        revertMove(board, moves[i], undo);
+    }
+
+    if (entry != NULL)
+        *entry = (PerftEntry) { key ^ found, found };
+
+    return found;
+}
+
+static void* perftWorker(void *argument) {
+
+    PerftWorker *worker = (PerftWorker*) argument;
+    Undo undo[1];
+
+    while (1) {
+
+        // Take the next root move which no Thread has started on
+        pthread_mutex_lock(worker->lock);
+        int index = (*worker->next)++;
+        pthread_mutex_unlock(worker->lock);
+
+        if (index >= worker->nmoves)
+            return NULL;
+
+        applyMove(&worker->board, worker->moves[index], undo);
+        worker->counts[index] = perftSearch(&worker->board, worker->depth - 1, worker->table);
+        revertMove(&worker->board, worker->moves[index], undo);
+    }
+}
+
+
+uint64_t perft(Board *board, int depth) {
+
+    // Single threaded and without a hash table, for when
+    // a result that relies on as little code as possible is wanted
+    return perftSearch(board, depth, NULL);
+}
+
+uint64_t perftThreaded(Board *board, int depth, int nthreads, uint64_t megabytes, int output) {
+
+    PerftTable table = {0};
+    pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+    uint16_t moves[MAX_MOVES];
+    uint64_t counts[MAX_MOVES] = {0}, found = 0ull;
+    int nmoves, next = 0;
+
+    double start = getRealTime();
+
+    if (depth <= 0) return 1ull;
+
+    // Use the largest power of two entries which fits in the given size
+    if (megabytes > 0) {
+        table.mask = 1ull;
+        while (2 * table.mask * sizeof(PerftEntry) <= megabytes * MB)
+            table.mask *= 2;
+        table.entries = calloc(table.mask--, sizeof(PerftEntry));
+    }
+
+    // The root moves are split between the Threads, with each Thread taking
+    // the next unsearched move as it finishes, so that large subtrees balance
+    nmoves = genAllLegalMoves(board, moves);
+    nthreads = MAX(1, MIN(nthreads, nmoves));
+
+    pthread_t pthreads[nthreads];
+    PerftWorker *workers = calloc(nthreads, sizeof(PerftWorker));
+
+    for (int i = 0; i < nthreads; i++) {
+
+        workers[i] = (PerftWorker) {
+            .table = megabytes > 0 ? &table : NULL, .moves = moves, .counts = counts,
+            .nmoves = nmoves, .depth = depth, .next = &next, .lock = &lock,
+        };
+
+        // Each Thread has its own Board, without the NNUE Accumulators
+        memcpy(&workers[i].board, board, sizeof(Board));
+        workers[i].board.nnue = NULL;
+
+        pthread_create(&pthreads[i], NULL, &perftWorker, &workers[i]);
+    }
+
+    for (int i = 0; i < nthreads; i++)
+        pthread_join(pthreads[i], NULL);
+
+    for (int i = 0; i < nmoves; i++) {
+
+        found += counts[i];
+
+        if (output == PERFT_DIVIDE) {
+            char moveStr[6];
+            moveToString(moves[i], moveStr, board->chess960);
+            printf("%s: %"PRIu64"\n", moveStr, counts[i]);
+        }
+    }
+
+    int elapsed = getRealTime() - start;
+
+    if (output != PERFT_QUIET)
+        printf("info string perft depth %d nodes %"PRIu64" time %d nps %"PRIu64"\n",
+            depth, found, elapsed, (uint64_t)(1000.0 * found / (elapsed + 1)));
+
+    free(workers);
+    free(table.entries);
+    return found;
+}
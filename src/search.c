@@ -26,17 +26,22 @@
 #include <string.h>
 #include <time.h>
 
+#include "attackmap.h"
 #include "attacks.h"
+#include "bitbase.h"
 #include "bitboards.h"
 #include "board.h"
+#include "book.h"
 #include "evaluate.h"
 #include "pyrrhic/tbprobe.h"
 #include "history.h"
+#include "mate.h"
 #include "move.h"
 #include "movegen.h"
 #include "movepicker.h"
 #include "search.h"
 #include "syzygy.h"
+#include "tablegen.h"
 #include "thread.h"
 #include "time.h"
 #include "transposition.h"
@@ -44,11 +49,23 @@
 #include "uci.h"
 #include "windows.h"
 
+#if defined(USE_PRECOMPUTED)
+    #include "precomputed/search.h"
+#else
 int LMRTable[64][64];      // Late Move Reductions
+#endif
 volatile int ABORT_SIGNAL; // Global ABORT flag for threads
 volatile int IS_PONDERING; // Global PONDER flag for threads
 volatile int ANALYSISMODE; // Whether to make some changes for Analysis
 
+#if defined(USE_PRECOMPUTED)
+
+void initSearch() {
+    // Tables were written out when building
+}
+
+#else
+
 void initSearch() {
 
     // Init Late Move Reductions Table
@@ -57,11 +74,30 @@ void initSearch() {
             LMRTable[depth][played] = 0.75 + log(depth) * log(played) / 2.25;
 }
 
+#endif
+
+void writeSearchTables(FILE *fout) {
+    writeTable(fout, "const int LMRTable", LMRTable, TABLE_INT, 2, 64, 64);
+}
+
 void getBestMove(Thread *threads, Board *board, Limits *limits, uint16_t *best, uint16_t *ponder) {
 
     SearchInfo info = {0};
     pthread_t pthreads[threads->nthreads];
 
+    // Probes miss until the Bitbases are ready, so only searches without
+    // a clock wait on them, which keeps fixed depth searches reproducible
+    BitbasesBlocking = !limits->limitedBySelf && !limits->limitedByTime;
+    if (BitbasesBlocking) waitForBitbases();
+
+    // Play directly from the opening book, when one is in use, but only
+    // when playing on a clock. Analysis and fixed searches always search
+    if (   (limits->limitedBySelf || limits->limitedByTime)
+        && !limits->limitedByNone && !limits->limitedByDepth && !limits->limitedByNodes
+        && !limits->limitedByMoves && !limits->limitedByMate && limits->multiPV == 1)
+        if (probeBook(board, best, ponder))
+            return;
+
     // Allow Syzygy to refine the move list for optimal results
     if (!limits->limitedByMoves && limits->multiPV == 1)
         if (tablebasesProbeDTZ(board, limits, best, ponder))
@@ -73,6 +109,14 @@ void getBestMove(Thread *threads, Board *board, Limits *limits, uint16_t *best,
     initTimeManagment(&info, limits);
     newSearchThreadPool(threads, board, limits, &info);
 
+    // Try to prove a mate with the proof-number search first. A stop
+    // during the proof search still returns the most promising move
+    if (limits->limitedByMate && (mateSearch(threads, limits) || ABORT_SIGNAL)) {
+        *best = info.bestMoves[info.depth];
+        *ponder = info.ponderMoves[info.depth];
+        return;
+    }
+
     // Create a new thread for each of the helpers and reuse the current
     // thread for the main thread, which avoids some overhead and saves
     // us from having the current thread eating CPU time while waiting
@@ -131,7 +175,8 @@ void* iterativeDeepening(void *vthread) {
         if (   (limits->limitedBySelf  && terminateTimeManagment(info))
             || (limits->limitedBySelf  && elapsedTime(info) > info->maxUsage)
             || (limits->limitedByTime  && elapsedTime(info) > limits->timeLimit)
-            || (limits->limitedByDepth && thread->depth >= limits->depthLimit))
+            || (limits->limitedByDepth && thread->depth >= limits->depthLimit)
+            || (limits->limitedByNodes && nodesSearchedThreadPool(thread->threads) >= limits->nodeLimit))
             break;
     }
 
@@ -236,6 +281,13 @@ int search(Thread *thread, PVariation *pv, int alpha, int beta, int depth) {
         // material. Add variance to the draw score, to avoid blindness to 3-fold lines
         if (boardIsDrawn(board, thread->height)) return 1 - (thread->nodes & 2);
 
+        // Upcoming Repetition. If a single move returns us to a position from
+        // the history, then we can claim at least a draw, a ply before reaching it
+        if (alpha < 0 && boardHasUpcomingRepetition(board, thread->height)) {
+            alpha = 1 - (thread->nodes & 2);
+            if (alpha >= beta) return alpha;
+        }
+
         // Check to see if we have exceeded the maxiumum search draft
         if (thread->height >= MAX_PLY)
             return evaluateBoard(thread, board);
@@ -267,8 +319,10 @@ int search(Thread *thread, PVariation *pv, int alpha, int beta, int depth) {
 
     // Step 5. Probe the Syzygy Tablebases. tablebasesProbeWDL() handles all of
     // the conditions about the board, the existance of tables, the probe depth,
-    // as well as to not probe at the Root. The return is defined by the Pyrrhic API
-    if ((tbresult = tablebasesProbeWDL(board, depth, thread->height)) != TB_RESULT_FAILED) {
+    // as well as to not probe at the Root. The return is defined by the Pyrrhic API.
+    // Without Syzygy, the generated Bitbases still resolve the 3-man endings and KRKP
+    if (   (tbresult = tablebasesProbeWDL(board, depth, thread->height)) != TB_RESULT_FAILED
+        || (tbresult = bitbasesProbeWDL(board, thread->height)) != TB_RESULT_FAILED) {
 
         thread->tbhits++; // Increment tbhits counter for this thread
 
@@ -626,6 +680,13 @@ int qsearch(Thread *thread, PVariation *pv, int alpha, int beta) {
     // material. Add variance to the draw score, to avoid blindness to 3-fold lines
     if (boardIsDrawn(board, thread->height)) return 1 - (thread->nodes & 2);
 
+    // Upcoming Repetition. If a single move returns us to a position from
+    // the history, then we can claim at least a draw, a ply before reaching it
+    if (alpha < 0 && boardHasUpcomingRepetition(board, thread->height)) {
+        alpha = 1 - (thread->nodes & 2);
+        if (alpha >= beta) return alpha;
+    }
+
     // Step 3. Max Draft Cutoff. If we are at the maximum search draft,
     // then end the search here with a static eval of the current board
     if (thread->height >= MAX_PLY)
@@ -643,9 +704,11 @@ int qsearch(Thread *thread, PVariation *pv, int alpha, int beta) {
             return ttValue;
     }
 
-    // Save a history of the static evaluations
+    // Save a history of the static evaluations. Without a TT eval, we allow
+    // the evaluation to exit early if it would be cut by Steps 5 or 6 anyway
     eval = thread->evalStack[thread->height]
-         = ttEval != VALUE_NONE ? ttEval : evaluateBoard(thread, board);
+         = ttEval != VALUE_NONE ? ttEval : evaluateBoardLazy(thread, board,
+             alpha - MAX(QSDeltaMargin, moveBestCaseValue(board)), beta);
 
     // Step 5. Eval Pruning. If a static evaluation of the board will
     // exceed beta, then we can stop the search here. Also, if the static
@@ -735,7 +798,15 @@ int staticExchangeEvaluation(Board *board, uint16_t move, int threshold) {
 
     // Get all pieces which attack the target square. And with occupied
     // so that we do not let the same piece attack twice
+#ifdef USE_ATTACK_MAPS
+    // The move only reveals sliders, so the map plus sliders is enough
+    attackers = attackMapAttackersTo(board, to)
+              | (bishopAttacks(to, occupied) & bishops)
+              | (  rookAttacks(to, occupied) & rooks);
+    attackers &= occupied;
+#else
     attackers = allAttackersToSquare(board, occupied, to) & occupied;
+#endif
 
     // Now our opponents turn to recapture
     colour = !board->turn;
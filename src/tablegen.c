@@ -0,0 +1,109 @@
+/*
+  Ethereal is a UCI chess playing engine authored by Andrew Grant.
+  <https://github.com/AndyGrant/Ethereal>     <andrew@grantnet.us>
+
+  Ethereal is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Ethereal is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include <inttypes.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "tablegen.h"
+
+static void writeElement(FILE *fout, const void *table, int type, int index) {
+
+    switch (type) {
+        case TABLE_U8:  fprintf(fout, "%d", ((const uint8_t  *) table)[index]); break;
+        case TABLE_U16: fprintf(fout, "%d", ((const uint16_t *) table)[index]); break;
+        case TABLE_INT: fprintf(fout, "%d", ((const int      *) table)[index]); break;
+        case TABLE_U64: fprintf(fout, "0x%016"PRIx64"ull", ((const uint64_t *) table)[index]); break;
+    }
+}
+
+static int writeDimension(FILE *fout, const void *table, int type, int ndims, const int *dims, int index, int indent) {
+
+    // Rows of the innermost dimension are wrapped every eight elements,
+    // and every other dimension gets its own set of nested braces
+
+    if (ndims == 1) {
+
+        fprintf(fout, "%*s", indent, "");
+
+        for (int i = 0; i < dims[0]; i++) {
+            writeElement(fout, table, type, index + i);
+            if (i == dims[0] - 1) break;
+            if (i % 8 == 7) fprintf(fout, ",\n%*s", indent, "");
+            else fprintf(fout, ", ");
+        }
+
+        return index + dims[0];
+    }
+
+    for (int i = 0; i < dims[0]; i++) {
+        fprintf(fout, "%*s{\n", indent, "");
+        index = writeDimension(fout, table, type, ndims - 1, dims + 1, index, indent + 4);
+        fprintf(fout, "\n%*s}%s\n", indent, "", i != dims[0] - 1 ? "," : "");
+    }
+
+    return index;
+}
+
+void writeTable(FILE *fout, const char *decl, const void *table, int type, int ndims, ...) {
+
+    // Writes "decl[d1]...[dn] = { ... };" for a table of the given type
+
+    int dims[8];
+    va_list args;
+
+    va_start(args, ndims);
+    fprintf(fout, "%s", decl);
+    for (int i = 0; i < ndims; i++)
+        fprintf(fout, "[%d]", dims[i] = va_arg(args, int));
+    va_end(args);
+
+    fprintf(fout, " = {\n");
+    writeDimension(fout, table, type, ndims, dims, 0, 4);
+    fprintf(fout, "%s};\n\n", ndims == 1 ? "\n" : "");
+}
+
+void runTableGenerator(int argc, char **argv) {
+
+    static const char *Names[] = { "attacks", "masks", "material", "search", "zobrist" };
+    static void (*Writers[])(FILE *) = {
+        writeAttackTables, writeMaskTables, writeMaterialTables,
+        writeSearchTables, writeZobristTables,
+    };
+
+    char fname[512];
+    const char *directory = argc > 2 ? argv[2] : "precomputed";
+
+    for (int i = 0; i < 5; i++) {
+
+        snprintf(fname, sizeof(fname), "%s/%s.h", directory, Names[i]);
+
+        FILE *fout = fopen(fname, "w");
+        if (fout == NULL) {
+            printf("Unable to open %s for writing\n", fname);
+            exit(EXIT_FAILURE);
+        }
+
+        fprintf(fout, "// Written by \"./Ethereal tablegen\". Do not edit\n\n");
+        Writers[i](fout);
+        fclose(fout);
+    }
+}
@@ -0,0 +1,35 @@
+/*
+  Ethereal is a UCI chess playing engine authored by Andrew Grant.
+  <https://github.com/AndyGrant/Ethereal>     <andrew@grantnet.us>
+
+  Ethereal is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Ethereal is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <stdio.h>
+
+#include "types.h"
+
+enum { TABLE_U8, TABLE_U16, TABLE_INT, TABLE_U64 };
+
+void runTableGenerator(int argc, char **argv);
+void writeTable(FILE *fout, const char *decl, const void *table, int type, int ndims, ...);
+
+void writeAttackTables(FILE *fout);
+void writeMaskTables(FILE *fout);
+void writeMaterialTables(FILE *fout);
+void writeSearchTables(FILE *fout);
+void writeZobristTables(FILE *fout);
@@ -20,8 +20,10 @@
 #include <string.h>
 
 #include "board.h"
+#include "evalcache.h"
 #include "evaluate.h"
 #include "history.h"
+#include "nnue.h"
 #include "search.h"
 #include "thread.h"
 #include "transposition.h"
@@ -48,9 +50,16 @@ Thread* createThreadPool(int nthreads) {
         threads[i].nthreads = nthreads;
     }
 
+    initPKTables(threads);
+
     return threads;
 }
 
+void deleteThreadPool(Thread *threads) {
+    freePKTables(threads);
+    free(threads);
+}
+
 void resetThreadPool(Thread *threads) {
 
     // Reset the per-thread tables, used for move ordering
@@ -60,7 +69,9 @@ void resetThreadPool(Thread *threads) {
     for (int i = 0; i < threads->nthreads; i++) {
 
         memset(&threads[i].evtable, 0, sizeof(EvalTable));
-        memset(&threads[i].pktable, 0, sizeof(PKTable));
+        if (threads[i].pktable != NULL)
+            memset(threads[i].pktable, 0, sizeof(PKTable));
+        memset(&threads[i].mttable, 0, sizeof(MaterialTable));
 
         memset(&threads[i].killers, 0, sizeof(KillerTable));
         memset(&threads[i].cmtable, 0, sizeof(CounterMoveTable));
@@ -69,6 +80,8 @@ void resetThreadPool(Thread *threads) {
         memset(&threads[i].chistory, 0, sizeof(CaptureHistoryTable));
         memset(&threads[i].continuation, 0, sizeof(ContinuationTable));
     }
+
+    clearSharedPKTable();
 }
 
 void newSearchThreadPool(Thread *threads, Board *board, Limits *limits, SearchInfo *info) {
@@ -76,7 +89,8 @@ void newSearchThreadPool(Thread *threads, Board *board, Limits *limits, SearchIn
     // Initialize each Thread in the Thread Pool. We need a reference
     // to the UCI seach parameters, access to the timing information,
     // somewhere to store the results of each iteration by the main, and
-    // our own copy of the board. Also, we reset the seach statistics
+    // our own copy of the board. Also, we reset the seach statistics,
+    // and the root of the NNUE Accumulator stack when NNUE is in use
 
     int contempt = MakeScore(ContemptDrawPenalty + ContemptComplexity, ContemptDrawPenalty);
 
@@ -90,6 +104,8 @@ void newSearchThreadPool(Thread *threads, Board *board, Limits *limits, SearchIn
         threads[i].tbhits    = 0ull;
 
         memcpy(&threads[i].board, board, sizeof(Board));
+        nnueResetAccumulator(&threads[i].nnueStack[0]);
+        threads[i].board.nnue = nnueEnabled() ? &threads[i].nnueStack[0] : NULL;
         threads[i].contempt = board->turn == WHITE ? contempt : -contempt;
     }
 }
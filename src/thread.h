@@ -24,7 +24,9 @@
 
 #include "board.h"
 #include "evalcache.h"
+#include "material.h"
 #include "network.h"
+#include "nnue.h"
 #include "search.h"
 #include "transposition.h"
 #include "types.h"
@@ -54,9 +56,12 @@ struct Thread {
     int *pieceStack, _pieceStack[STACK_SIZE];
 
     Undo undoStack[STACK_SIZE];
+    NNUEAccumulator nnueStack[STACK_SIZE];
 
     ALIGN64 EvalTable evtable;
-    ALIGN64 PKTable pktable;
+    PKEntry *pktable;  // Not allocated while the SharedPKTable is in use
+    PKEntry pkshared; // Verified copy of an entry from the SharedPKTable
+    ALIGN64 MaterialTable mttable;
 
     ALIGN64 KillerTable killers;
     ALIGN64 CounterMoveTable cmtable;
@@ -72,6 +77,7 @@ struct Thread {
 
 
 Thread* createThreadPool(int nthreads);
+void deleteThreadPool(Thread *threads);
 void resetThreadPool(Thread *threads);
 void newSearchThreadPool(Thread *threads, Board *board, Limits *limits, SearchInfo *info);
 uint64_t nodesSearchedThreadPool(Thread *threads);
@@ -128,8 +128,24 @@ int terminateSearchEarly(Thread *thread) {
 
     const Limits *limits = thread->limits;
 
-    return  thread->depth > 1
-        && (thread->nodes & 1023) == 1023
+    if (thread->depth <= 1)
+        return 0;
+
+    // Node limited searches with a single thread compare against the
+    // exact node count at every node, so the search is reproducible. With
+    // helper threads we sum the counters for the pool every 1024 nodes
+    if (limits->limitedByNodes) {
+
+        if (thread->nthreads == 1 && thread->nodes >= limits->nodeLimit)
+            return 1;
+
+        if (   thread->nthreads > 1
+            && (thread->nodes & 1023) == 1023
+            && nodesSearchedThreadPool(thread->threads) >= limits->nodeLimit)
+            return 1;
+    }
+
+    return (thread->nodes & 1023) == 1023
         && (limits->limitedBySelf || limits->limitedByTime)
         &&  elapsedTime(thread->info) >= thread->info->maxUsage;
 }
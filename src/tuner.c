@@ -43,80 +43,6 @@ int TupleStackSize = STACKSIZE;
 // Tap into evaluate()
 extern EvalTrace T, EmptyTrace;
 
-extern const int PawnValue;
-extern const int KnightValue;
-extern const int BishopValue;
-extern const int RookValue;
-extern const int QueenValue;
-extern const int PawnPSQT[64];
-extern const int KnightPSQT[64];
-extern const int BishopPSQT[64];
-extern const int RookPSQT[64];
-extern const int QueenPSQT[64];
-extern const int KingPSQT[64];
-extern const int PawnCandidatePasser[2][8];
-extern const int PawnIsolated[8];
-extern const int PawnStacked[2][8];
-extern const int PawnBackwards[2][8];
-extern const int PawnConnected32[32];
-extern const int KnightOutpost[2][2];
-extern const int KnightBehindPawn;
-extern const int KnightInSiberia[4];
-extern const int KnightMobility[9];
-extern const int BishopPair;
-extern const int BishopRammedPawns;
-extern const int BishopOutpost[2][2];
-extern const int BishopBehindPawn;
-extern const int BishopLongDiagonal;
-extern const int BishopMobility[14];
-extern const int RookFile[2];
-extern const int RookOnSeventh;
-extern const int RookMobility[15];
-extern const int QueenRelativePin;
-extern const int QueenMobility[28];
-extern const int KingDefenders[12];
-extern const int KingPawnFileProximity[8];
-extern const int KingShelter[2][8][8];
-extern const int KingStorm[2][4][8];
-extern const int SafetyKnightWeight;
-extern const int SafetyBishopWeight;
-extern const int SafetyRookWeight;
-extern const int SafetyQueenWeight;
-extern const int SafetyAttackValue;
-extern const int SafetyWeakSquares;
-extern const int SafetyNoEnemyQueens;
-extern const int SafetySafeQueenCheck;
-extern const int SafetySafeRookCheck;
-extern const int SafetySafeBishopCheck;
-extern const int SafetySafeKnightCheck;
-extern const int SafetyAdjustment;
-extern const int SafetyShelter[2][8];
-extern const int SafetyStorm[2][8];
-extern const int PassedPawn[2][2][8];
-extern const int PassedFriendlyDistance[8];
-extern const int PassedEnemyDistance[8];
-extern const int PassedSafePromotionPath;
-extern const int ThreatWeakPawn;
-extern const int ThreatMinorAttackedByPawn;
-extern const int ThreatMinorAttackedByMinor;
-extern const int ThreatMinorAttackedByMajor;
-extern const int ThreatRookAttackedByLesser;
-extern const int ThreatMinorAttackedByKing;
-extern const int ThreatRookAttackedByKing;
-extern const int ThreatQueenAttackedByOne;
-extern const int ThreatOverloadedPieces;
-extern const int ThreatByPawnPush;
-extern const int SpaceRestrictPiece;
-extern const int SpaceRestrictEmpty;
-extern const int SpaceCenterControl;
-extern const int ClosednessKnightAdjustment[9];
-extern const int ClosednessRookAdjustment[9];
-extern const int ComplexityTotalPawns;
-extern const int ComplexityPawnFlanks;
-extern const int ComplexityPawnEndgame;
-extern const int ComplexityAdjustment;
-extern const int Tempo;
-
 
 void runTuner() {
 
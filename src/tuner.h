@@ -188,14 +188,14 @@ void print_3(char *name, TVector params, int i, int A, int B, int C, char *S);
 // Initalize Parameters of an N dimensional array
 
 #define INIT_PARAM_0(term, M, S) do {                           \
-     cparams[i  ][MG] = ScoreMG(term);                          \
-     cparams[i++][EG] = ScoreEG(term);                          \
+     cparams[i  ][MG] = ScoreMG(Params.term);                   \
+     cparams[i++][EG] = ScoreEG(Params.term);                   \
 } while (0)
 
 #define INIT_PARAM_1(term, A, M, S) do {                        \
     for (int _a = 0; _a < A; _a++)                              \
-       {cparams[i  ][MG] = ScoreMG(term[_a]);                   \
-        cparams[i++][EG] = ScoreEG(term[_a]);}                  \
+       {cparams[i  ][MG] = ScoreMG(Params.term[_a]);            \
+        cparams[i++][EG] = ScoreEG(Params.term[_a]);}           \
 } while (0)
 
 #define INIT_PARAM_2(term, A, B, M, S) do {                     \
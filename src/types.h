@@ -77,17 +77,25 @@ static inline int makePiece(int type, int colour) {
 // Forward definition of all structs
 
 typedef struct Magic Magic;
+typedef struct AttackMap AttackMap;
 typedef struct Board Board;
 typedef struct Undo Undo;
+typedef struct EvalParams EvalParams;
 typedef struct EvalTrace EvalTrace;
 typedef struct EvalInfo EvalInfo;
 typedef struct MovePicker MovePicker;
+typedef struct NNUEAccumulator NNUEAccumulator;
 typedef struct SearchInfo SearchInfo;
 typedef struct PVariation PVariation;
 typedef struct Thread Thread;
 typedef struct TTEntry TTEntry;
 typedef struct TTBucket TTBucket;
 typedef struct PKEntry PKEntry;
+typedef struct SharedPKEntry SharedPKEntry;
+typedef struct MaterialEntry MaterialEntry;
+typedef struct PNEntry PNEntry;
+typedef struct PerftEntry PerftEntry;
+typedef struct PolyglotEntry PolyglotEntry;
 typedef struct TTable TTable;
 typedef struct Limits Limits;
 typedef struct UCIGoStruct UCIGoStruct;
@@ -104,3 +112,17 @@ typedef int16_t CaptureHistoryTable[PIECE_NB][SQUARE_NB][PIECE_NB-1];
 // Trivial alignment macros
 
 #define ALIGN64 alignas(64)
+
+// Forced inlining, used to specialise routines on a constant colour
+
+#define INLINE static inline __attribute__((always_inline))
+
+// Lookup tables are const data when written out by "./Ethereal tablegen"
+// and compiled back in, so that startup pages them in instead of building
+// them. See "make precomputed"
+
+#if defined(USE_PRECOMPUTED)
+    #define TABLE const
+#else
+    #define TABLE
+#endif
@@ -24,32 +24,42 @@
 #include <string.h>
 
 #include "attacks.h"
+#include "bitbase.h"
 #include "board.h"
+#include "book.h"
 #include "cmdline.h"
+#include "cpu.h"
+#include "evalcache.h"
 #include "evaluate.h"
 #include "pyrrhic/tbprobe.h"
 #include "history.h"
 #include "masks.h"
+#include "material.h"
 #include "move.h"
 #include "movegen.h"
 #include "network.h"
 #include "nneval.h"
+#include "nnue.h"
+#include "perft.h"
 #include "search.h"
 #include "thread.h"
 #include "time.h"
 #include "transposition.h"
 #include "types.h"
 #include "uci.h"
+#include "weights.h"
 #include "zobrist.h"
 
 extern int ContemptDrawPenalty;   // Defined by thread.c
 extern int ContemptComplexity;    // Defined by thread.c
 extern int MoveOverhead;          // Defined by time.c
+extern int OwnBook;               // Defined by book.c
+extern int BookBestMove;          // Defined by book.c
+extern int UseNNUE;               // Defined by nnue.c
 extern unsigned TB_PROBE_DEPTH;   // Defined by syzygy.c
 extern volatile int ABORT_SIGNAL; // Defined by search.c
 extern volatile int IS_PONDERING; // Defined by search.c
 extern volatile int ANALYSISMODE; // Defined by search.c
-extern PKNetwork PKNN;            // Defined by network.c
 
 pthread_mutex_t READYLOCK = PTHREAD_MUTEX_INITIALIZER;
 const char *StartPosition = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
@@ -66,9 +76,10 @@ int main(int argc, char **argv) {
     int multiPV  = 1;
 
     // Initialize core components of Ethereal
-    initAttacks(); initMasks(); initEval();
-    initSearch(); initZobrist(); initTT(16);
-    initPKNetwork(&PKNN); initEndgameNNs();
+    initCPU(); initAttacks(); initMasks(); initEval();
+    initSearch(); initZobrist(); initMaterial(); initTT(16);
+    initWeights(NULL);
+    initBitbases();
 
     // Create the UCI-board and our threads
     threads = createThreadPool(1);
@@ -91,6 +102,7 @@ int main(int argc, char **argv) {
     |       stop |            Signals the search threads to finish and report a bestmove |
     |       quit |             Exits the engine and any searches by killing the UCI loop |
     |      perft |            Custom command to compute PERFT(N) of the current position |
+    |            |     Uses the Threads and Hash options, "perft divide N" lists each move |
     |      print |         Custom command to print an ASCII view of the current position |
     |------------|-----------------------------------------------------------------------|
     */
@@ -100,14 +112,23 @@ int main(int argc, char **argv) {
         if (strEquals(str, "uci")) {
             printf("id name Ethereal " ETHEREAL_VERSION "\n");
             printf("id author Andrew Grant, Alayan & Laldon\n");
+            printf("info string Using %s\n", cpuDescription());
             printf("option name Hash type spin default 16 min 2 max 131072\n");
             printf("option name Threads type spin default 1 min 1 max 2048\n");
+            printf("option name SharedPKHash type spin default 0 min 0 max 4096\n");
             printf("option name MultiPV type spin default 1 min 1 max 256\n");
             printf("option name ContemptDrawPenalty type spin default 0 min -300 max 300\n");
             printf("option name ContemptComplexity type spin default 0 min -100 max 100\n");
             printf("option name MoveOverhead type spin default 100 min 0 max 10000\n");
             printf("option name SyzygyPath type string default <empty>\n");
             printf("option name SyzygyProbeDepth type spin default 0 min 0 max 127\n");
+            printf("option name OwnBook type check default false\n");
+            printf("option name BookFile type string default <empty>\n");
+            printf("option name BookBestMove type check default false\n");
+            printf("option name UseNNUE type check default false\n");
+            printf("option name EvalFile type string default <empty>\n");
+            printf("option name WeightsFile type string default <empty>\n");
+            printf("option name EvalParamsFile type string default <empty>\n");
             printf("option name Ponder type check default false\n");
             printf("option name AnalysisMode type check default false\n");
             printf("option name UCI_Chess960 type check default false\n");
@@ -128,7 +149,7 @@ int main(int argc, char **argv) {
 
         else if (strStartsWith(str, "setoption")) {
             pthread_mutex_lock(&READYLOCK);
-            uciSetOption(str, &threads, &multiPV, &chess960);
+            uciSetOption(str, &threads, &board, &multiPV, &chess960);
             pthread_mutex_unlock(&READYLOCK);
         }
 
@@ -157,8 +178,11 @@ int main(int argc, char **argv) {
         else if (strEquals(str, "quit"))
             break;
 
+        else if (strStartsWith(str, "perft divide"))
+            perftThreaded(&board, atoi(str + strlen("perft divide ")), threads->nthreads, hashSizeMBTT(), PERFT_DIVIDE), fflush(stdout);
+
         else if (strStartsWith(str, "perft"))
-            printf("%"PRIu64"\n", perft(&board, atoi(str + strlen("perft ")))), fflush(stdout);
+            printf("%"PRIu64"\n", perftThreaded(&board, atoi(str + strlen("perft ")), threads->nthreads, hashSizeMBTT(), PERFT_REPORT)), fflush(stdout);
 
         else if (strStartsWith(str, "print"))
             printBoard(&board), fflush(stdout);
@@ -176,7 +200,8 @@ void *uciGo(void *cargo) {
     uint16_t bestMove, ponderMove;
     char moveStr[6];
 
-    int depth = 0, infinite = 0;
+    int depth = 0, infinite = 0, mate = 0;
+    uint64_t nodes = 0ull;
     double wtime = 0, btime = 0, movetime = 0;
     double winc = 0, binc = 0, mtg = -1;
 
@@ -205,6 +230,8 @@ void *uciGo(void *cargo) {
         if (strEquals(ptr, "movestogo"  )) mtg      = atoi(strtok(NULL, " "));
         if (strEquals(ptr, "depth"      )) depth    = atoi(strtok(NULL, " "));
         if (strEquals(ptr, "movetime"   )) movetime = atoi(strtok(NULL, " "));
+        if (strEquals(ptr, "mate"       )) mate     = atoi(strtok(NULL, " "));
+        if (strEquals(ptr, "nodes"      )) nodes    = strtoull(strtok(NULL, " "), NULL, 10);
 
         if (strEquals(ptr, "infinite"   )) infinite = 1;
         if (strEquals(ptr, "searchmoves")) searchmoves = 1;
@@ -216,14 +243,27 @@ void *uciGo(void *cargo) {
         }
     }
 
+    // Mate searches use two plies per move, and must fit into the stacks
+    mate = MAX(0, MIN((MAX_PLY - 1) / 2, mate));
+
     // Initialize limits for the search
     limits.limitedByNone  = infinite != 0;
     limits.limitedByTime  = movetime != 0;
     limits.limitedByDepth = depth    != 0;
-    limits.limitedBySelf  = !depth && !movetime && !infinite;
+    limits.limitedByNodes = nodes    != 0;
+    limits.limitedByMate  = mate     != 0;
+    limits.limitedBySelf  = !depth && !movetime && !infinite && !nodes && !mate;
     limits.limitedByMoves = searchmoves;
     limits.timeLimit      = movetime;
     limits.depthLimit     = depth;
+    limits.nodeLimit      = nodes;
+    limits.mateLimit      = mate;
+
+    // Searches for a mate fall back to a depth limited search
+    if (mate && !depth && !movetime && !infinite && !nodes) {
+        limits.limitedByDepth = 1;
+        limits.depthLimit     = MIN(MAX_PLY - 1, 2 * mate);
+    }
 
     // Pick the time values for the colour we are playing as
     limits.start = (board->turn == WHITE) ? start : start;
@@ -259,17 +299,25 @@ void *uciGo(void *cargo) {
     return NULL;
 }
 
-void uciSetOption(char *str, Thread **threads, int *multiPV, int *chess960) {
+void uciSetOption(char *str, Thread **threads, Board *board, int *multiPV, int *chess960) {
 
     // Handle setting UCI options in Ethereal. Options include:
     //  Hash                : Size of the Transposition Table in Megabyes
     //  Threads             : Number of search threads to use
+    //  SharedPKHash        : Size of a Pawn King Table shared by all threads in Megabytes, or 0 for one per thread
     //  MultiPV             : Number of search lines to report per iteration
     //  ContemptDrawPenalty : Evaluation bonus in internal units to avoid forced draws
     //  ContemptComplexity  : Evaluation bonus for keeping a position with more non-pawn material
     //  MoveOverhead        : Overhead on time allocation to avoid time losses
     //  SyzygyPath          : Path to Syzygy Tablebases
     //  SyzygyProbeDepth    : Minimal Depth to probe the highest cardinality Tablebase
+    //  OwnBook             : Play moves from the Polyglot book when one is found
+    //  BookFile            : Path to a Polyglot opening book
+    //  BookBestMove        : Always play the heaviest book move, instead of a weighted choice
+    //  UseNNUE             : Evaluate with the NNUE from EvalFile instead of the hand crafted evaluation
+    //  EvalFile            : Path to a HalfKP NNUE file, in the Stockfish 12 format
+    //  WeightsFile         : Path to a binary file of PK and EG networks, or <empty> for the built in ones
+    //  EvalParamsFile      : Path to hand crafted evaluation terms printed by the Tuner, or <empty> for the built in ones
     //  UCI_Chess960        : Set when playing FRC, but not required in order to work
 
     if (strStartsWith(str, "setoption name Hash value ")) {
@@ -279,10 +327,16 @@ void uciSetOption(char *str, Thread **threads, int *multiPV, int *chess960) {
 
     if (strStartsWith(str, "setoption name Threads value ")) {
         int nthreads = atoi(str + strlen("setoption name Threads value "));
-        free(*threads); *threads = createThreadPool(nthreads);
+        deleteThreadPool(*threads); *threads = createThreadPool(nthreads);
         printf("info string set Threads to %d\n", nthreads);
     }
 
+    if (strStartsWith(str, "setoption name SharedPKHash value ")) {
+        int megabytes = atoi(str + strlen("setoption name SharedPKHash value "));
+        initSharedPKTable(*threads, megabytes); printf("info string set SharedPKHash to %dMB\n", sharedPKTableSizeMB());
+        resetThreadPool(*threads); // Cached evaluations are now stale
+    }
+
     if (strStartsWith(str, "setoption name MultiPV value ")) {
         *multiPV = atoi(str + strlen("setoption name MultiPV value "));
         printf("info string set MultiPV to %d\n", *multiPV);
@@ -313,6 +367,59 @@ void uciSetOption(char *str, Thread **threads, int *multiPV, int *chess960) {
         printf("info string set SyzygyProbeDepth to %u\n", TB_PROBE_DEPTH);
     }
 
+    if (strStartsWith(str, "setoption name OwnBook value ")) {
+        if (strStartsWith(str, "setoption name OwnBook value true"))
+            printf("info string set OwnBook to true\n"), OwnBook = 1;
+        if (strStartsWith(str, "setoption name OwnBook value false"))
+            printf("info string set OwnBook to false\n"), OwnBook = 0;
+    }
+
+    if (strStartsWith(str, "setoption name BookFile value ")) {
+        char *ptr = str + strlen("setoption name BookFile value ");
+        int empty = strEquals(ptr, "") || strEquals(ptr, "<empty>");
+        if (initBook(empty ? NULL : ptr)) printf("info string set BookFile to %s\n", ptr);
+        else printf("info string unable to load BookFile %s\n", ptr);
+    }
+
+    if (strStartsWith(str, "setoption name BookBestMove value ")) {
+        if (strStartsWith(str, "setoption name BookBestMove value true"))
+            printf("info string set BookBestMove to true\n"), BookBestMove = 1;
+        if (strStartsWith(str, "setoption name BookBestMove value false"))
+            printf("info string set BookBestMove to false\n"), BookBestMove = 0;
+    }
+
+    if (strStartsWith(str, "setoption name UseNNUE value ")) {
+        if (strStartsWith(str, "setoption name UseNNUE value true"))
+            printf("info string set UseNNUE to true\n"), UseNNUE = 1;
+        if (strStartsWith(str, "setoption name UseNNUE value false"))
+            printf("info string set UseNNUE to false\n"), UseNNUE = 0;
+        resetThreadPool(*threads); // Cached evaluations are now stale
+    }
+
+    if (strStartsWith(str, "setoption name EvalFile value ")) {
+        char *ptr = str + strlen("setoption name EvalFile value ");
+        if (initNNUE(ptr)) printf("info string set EvalFile to %s\n", ptr);
+        else printf("info string unable to load EvalFile %s\n", ptr);
+        resetThreadPool(*threads); // Cached evaluations are now stale
+    }
+
+    if (strStartsWith(str, "setoption name WeightsFile value ")) {
+        char *ptr = str + strlen("setoption name WeightsFile value ");
+        int builtin = strEquals(ptr, "") || strEquals(ptr, "<empty>");
+        if (initWeights(builtin ? NULL : ptr)) printf("info string set WeightsFile to %s\n", ptr);
+        else printf("info string unable to load WeightsFile %s\n", ptr);
+        refreshPKAccumulator(board, board->pkaccum);
+        resetThreadPool(*threads); // Cached evaluations are now stale
+    }
+
+    if (strStartsWith(str, "setoption name EvalParamsFile value ")) {
+        char *ptr = str + strlen("setoption name EvalParamsFile value ");
+        int builtin = strEquals(ptr, "") || strEquals(ptr, "<empty>");
+        if (loadEvalParams(builtin ? NULL : ptr)) printf("info string set EvalParamsFile to %s\n", ptr);
+        else printf("info string unable to load EvalParamsFile %s\n", ptr);
+        resetThreadPool(*threads); // Cached evaluations are now stale
+    }
+
     if (strStartsWith(str, "setoption name AnalysisMode value ")) {
         if (strStartsWith(str, "setoption name AnalysisMode value true"))
             printf("info string set AnalysisMode to true\n"), ANALYSISMODE = 1;
@@ -332,42 +439,64 @@ void uciSetOption(char *str, Thread **threads, int *multiPV, int *chess960) {
 
 void uciPosition(char *str, Board *board, int chess960) {
 
-    int size;
-    uint16_t moves[MAX_MOVES];
-    char *ptr, moveStr[6],testStr[6];
+    static char lastBase[8192], lastMoves[8192];
+    static int lastChess960 = -1;
+
+    uint16_t move;
+    char *ptr, moveStr[6];
     Undo undo[1];
 
+    // Split the command into the base position and the move list
+    char *moves = strstr(str, "moves");
+    int baseLength = moves != NULL ? moves - str : (int) strlen(str);
+    while (baseLength > 0 && str[baseLength-1] == ' ') baseLength--;
+
+    ptr = moves != NULL ? moves + strlen("moves") : str + strlen(str);
+    while (*ptr == ' ') ptr++;
+
+    // Interfaces resend the entire game with each new move. When the base
+    // position is unchanged, and the move list extends the one previously
+    // sent, only the newly appended moves need to be applied to the board
+    int applied = strlen(lastMoves);
+    int extends =  chess960 == lastChess960
+               &&  baseLength == (int) strlen(lastBase)
+               && !strncmp(str, lastBase, baseLength)
+               && !strncmp(ptr, lastMoves, applied)
+               && (applied == 0 || ptr[applied] == ' ' || ptr[applied] == '\0');
+
+    // Save the command for the next call, without any trailing white space
+    strncpy(lastBase, str, baseLength), lastBase[baseLength] = '\0';
+    strcpy(lastMoves, ptr), lastChess960 = chess960;
+    for (int i = strlen(lastMoves) - 1; i >= 0 && lastMoves[i] == ' '; i--)
+        lastMoves[i] = '\0';
+
+    if (extends) {
+        ptr += applied;
+        while (*ptr == ' ') ptr++;
+    }
+
     // Position is defined by a FEN, X-FEN or Shredder-FEN
-    if (strContains(str, "fen"))
+    else if (strContains(str, "fen"))
         boardFromFEN(board, strstr(str, "fen") + strlen("fen "), chess960);
 
     // Position is simply the usual starting position
     else if (strContains(str, "startpos"))
         boardFromFEN(board, StartPosition, chess960);
 
-    // Position command may include a list of moves
-    ptr = strstr(str, "moves");
-    if (ptr != NULL)
-        ptr += strlen("moves ");
-
     // Apply each move in the move list
-    while (ptr != NULL && *ptr != '\0') {
+    while (*ptr != '\0') {
 
         // UCI sends moves in long algebraic notation
         for (int i = 0; i < 4; i++) moveStr[i] = *ptr++;
         moveStr[4] = *ptr == '\0' || *ptr == ' ' ? '\0' : *ptr++;
         moveStr[5] = '\0';
 
-        // Generate moves for this position
-        size = genAllLegalMoves(board, moves);
-
-        // Find and apply the given move
-        for (int i = 0; i < size; i++) {
-            moveToString(moves[i], testStr, board->chess960);
-            if (strEquals(moveStr, testStr)) {
-                applyMove(board, moves[i], undo);
-                break;
-            }
+        // Decode the move directly, and then verify that it is legal
+        move = stringToMove(board, moveStr);
+        if (moveIsPseudoLegal(board, move)) {
+            applyMove(board, move, undo);
+            if (!moveWasLegal(board))
+                revertMove(board, move, undo);
         }
 
         // Reset move history whenever we reset the fifty move rule. This way
@@ -423,6 +552,20 @@ void uciReport(Thread *threads, int alpha, int beta, int value) {
     puts(""); fflush(stdout);
 }
 
+void uciReportProgress(Thread *threads, int depth) {
+
+    // Report the node count without a score, for long
+    // searches which have not finished their iteration yet
+
+    int elapsed     = elapsedTime(threads->info);
+    uint64_t nodes  = nodesSearchedThreadPool(threads);
+    int nps         = (int)(1000 * (nodes / (1 + elapsed)));
+
+    printf("info depth %d seldepth %d time %d nodes %"PRIu64" nps %d\n",
+           depth, threads->seldepth, elapsed, nodes, nps);
+    fflush(stdout);
+}
+
 void uciReportCurrentMove(Board *board, uint16_t move, int currmove, int depth) {
 
     char moveStr[6];
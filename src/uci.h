@@ -24,7 +24,9 @@
 
 #define VERSION_ID "12.69"
 
-#if defined(USE_PEXT)
+#if defined(USE_DISPATCH)
+    #define ETHEREAL_VERSION VERSION_ID" (DISPATCH)"
+#elif defined(USE_PEXT)
     #define ETHEREAL_VERSION VERSION_ID" (PEXT)"
 #elif defined(USE_POPCNT)
     #define ETHEREAL_VERSION VERSION_ID" (POPCNT)"
@@ -35,7 +37,9 @@
 struct Limits {
     double start, time, inc, mtg, timeLimit;
     int limitedByNone, limitedByTime, limitedBySelf;
-    int limitedByDepth, limitedByMoves, depthLimit, multiPV;
+    int limitedByDepth, limitedByMoves, limitedByNodes, limitedByMate;
+    int depthLimit, mateLimit, multiPV;
+    uint64_t nodeLimit;
     uint16_t searchMoves[MAX_MOVES], excludedMoves[MAX_MOVES];
 };
 
@@ -47,10 +51,11 @@ struct UCIGoStruct {
 };
 
 void *uciGo(void *cargo);
-void uciSetOption(char *str, Thread **threads, int *multiPV, int *chess960);
+void uciSetOption(char *str, Thread **threads, Board *board, int *multiPV, int *chess960);
 void uciPosition(char *str, Board *board, int chess960);
 
 void uciReport(Thread *threads, int alpha, int beta, int value);
+void uciReportProgress(Thread *threads, int depth);
 void uciReportCurrentMove(Board *board, uint16_t move, int currmove, int depth);
 
 int strEquals(char *str1, char *str2);
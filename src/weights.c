@@ -0,0 +1,182 @@
+/*
+  Ethereal is a UCI chess playing engine authored by Andrew Grant.
+  <https://github.com/AndyGrant/Ethereal>     <andrew@grantnet.us>
+
+  Ethereal is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Ethereal is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32) || defined(_WIN64)
+    #include <malloc.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#include "network.h"
+#include "nneval.h"
+#include "weights.h"
+
+// The default networks are embedded into the binary at build time, already
+// aligned and in their final form, so that they may be used in place
+
+#if defined(__APPLE__)
+    #define WEIGHTS_SYMBOL(name) "_" #name
+    #define WEIGHTS_SECTION ".const_data\n"
+#elif defined(_WIN32) || defined(_WIN64)
+    #define WEIGHTS_SYMBOL(name) #name
+    #define WEIGHTS_SECTION ".section .rdata,\"dr\"\n"
+#else
+    #define WEIGHTS_SYMBOL(name) #name
+    #define WEIGHTS_SECTION ".section .rodata\n"
+#endif
+
+__asm__(
+    WEIGHTS_SECTION
+    ".balign 64\n"
+    ".global " WEIGHTS_SYMBOL(EmbeddedWeights) "\n"
+    WEIGHTS_SYMBOL(EmbeddedWeights) ":\n"
+    ".incbin \"" WEIGHTS_FILE "\"\n"
+    ".global " WEIGHTS_SYMBOL(EmbeddedWeightsEnd) "\n"
+    WEIGHTS_SYMBOL(EmbeddedWeightsEnd) ":\n"
+    ".text\n"
+);
+
+extern const uint8_t EmbeddedWeights[], EmbeddedWeightsEnd[];
+
+static const uint8_t *WeightsData; // Embedded, or a file loaded by initWeights()
+static size_t WeightsSize;
+static int WeightsOwned;           // Whether WeightsData must be released
+
+static int loadWeightsFile(const char *path, const uint8_t **data, size_t *size) {
+
+    // Map the file, which needs no copy and keeps it shared by all of the
+    // engines running on a machine. Without mmap() we read into an aligned
+    // buffer instead, since the networks are used with aligned loads
+
+#if defined(_WIN32) || defined(_WIN64)
+
+    FILE *fin = fopen(path, "rb");
+    if (fin == NULL) return 0;
+
+    fseek(fin, 0, SEEK_END);
+    *size = ftell(fin);
+    fseek(fin, 0, SEEK_SET);
+
+    uint8_t *buffer = _aligned_malloc(*size, 64);
+    if (buffer != NULL && fread(buffer, 1, *size, fin) != *size)
+        _aligned_free(buffer), buffer = NULL;
+
+    fclose(fin);
+    return (*data = buffer) != NULL;
+
+#else
+
+    struct stat st;
+    int fd = open(path, O_RDONLY);
+    if (fd == -1) return 0;
+
+    *data = NULL;
+
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        *size = st.st_size;
+        *data = mmap(NULL, *size, PROT_READ, MAP_SHARED, fd, 0);
+        if (*data == MAP_FAILED) *data = NULL;
+    }
+
+    close(fd);
+    return *data != NULL;
+
+#endif
+}
+
+static void releaseWeights(const uint8_t *data, size_t size, int owned) {
+
+    if (!owned) return;
+
+#if defined(_WIN32) || defined(_WIN64)
+    (void) size; _aligned_free((void *) data);
+#else
+    munmap((void *) data, size);
+#endif
+}
+
+static int validateWeights() {
+
+    // Check the version and that every section lies within the file, on
+    // a 64 byte boundary. Sections are otherwise checked when looked up
+
+    const WeightsHeader *header = (const WeightsHeader *) WeightsData;
+    const WeightsSection *table = (const WeightsSection *) (header + 1);
+
+    if (   WeightsSize < sizeof(WeightsHeader)
+        || header->magic != WEIGHTS_MAGIC
+        || header->version != WEIGHTS_VERSION
+        || header->sections > (WeightsSize - sizeof(WeightsHeader)) / sizeof(WeightsSection))
+        return 0;
+
+    for (uint32_t i = 0; i < header->sections; i++)
+        if (   table[i].offset % 64 != 0
+            || table[i].offset > WeightsSize
+            || table[i].bytes > WeightsSize - table[i].offset)
+            return 0;
+
+    return 1;
+}
+
+
+int initWeights(const char *path) {
+
+    const uint8_t *oldData = WeightsData, *data = EmbeddedWeights;
+    size_t oldSize = WeightsSize, size = EmbeddedWeightsEnd - EmbeddedWeights;
+    int oldOwned = WeightsOwned, owned = path != NULL;
+
+    // Use the embedded networks when no file is given
+    if (path != NULL && !loadWeightsFile(path, &data, &size))
+        return 0;
+
+    WeightsData = data, WeightsSize = size, WeightsOwned = owned;
+
+    if (validateWeights() && initPKNetwork() && initEndgameNNs()) {
+        releaseWeights(oldData, oldSize, oldOwned);
+        return 1;
+    }
+
+    // Restore the previous networks, which are known to be valid
+    releaseWeights(data, size, owned);
+    WeightsData = oldData, WeightsSize = oldSize, WeightsOwned = oldOwned;
+    if (WeightsData != NULL) initPKNetwork(), initEndgameNNs();
+
+    return 0;
+}
+
+const void *weightsSection(const char *name, size_t bytes) {
+
+    const WeightsHeader *header = (const WeightsHeader *) WeightsData;
+    const WeightsSection *table = (const WeightsSection *) (header + 1);
+
+    // Sections must match both by name and by their expected size
+    for (uint32_t i = 0; i < header->sections; i++)
+        if (!strncmp(table[i].name, name, sizeof(table[i].name)))
+            return table[i].bytes == bytes ? WeightsData + table[i].offset : NULL;
+
+    return NULL;
+}
@@ -0,0 +1,44 @@
+/*
+  Ethereal is a UCI chess playing engine authored by Andrew Grant.
+  <https://github.com/AndyGrant/Ethereal>     <andrew@grantnet.us>
+
+  Ethereal is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Ethereal is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "types.h"
+
+#define WEIGHTS_FILE "weights/networks.bin"
+
+enum {
+    WEIGHTS_MAGIC   = 0x57485445, // "ETHW", little endian
+    WEIGHTS_VERSION = 1,
+};
+
+typedef struct WeightsHeader {
+    uint32_t magic, version, sections, reserved;
+} WeightsHeader;
+
+typedef struct WeightsSection {
+    char name[48];
+    uint64_t offset, bytes;
+} WeightsSection;
+
+int initWeights(const char *path);
+const void *weightsSection(const char *name, size_t bytes);
@@ -0,0 +1,111 @@
+# Ethereal is a UCI chess playing engine authored by Andrew Grant.
+# <https://github.com/AndyGrant/Ethereal>     <andrew@grantnet.us>
+#
+# Ethereal is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# Ethereal is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# Converts the text networks in this directory into a single versioned
+# binary file, which Ethereal embeds at build time and may also load at
+# runtime with the WeightsFile UCI option. Parameters are written already
+# in the form used by the engine, so that they can be used in place:
+#
+#   PK Network  : int16 Input and Output Layers, scaled by 128 and 64
+#   EG Networks : float32, with the Input Weights stored input-major
+#
+# USAGE: python3 convert.py [output] (defaults to networks.bin)
+#
+# Layout: a 16 byte header of the magic "ETHW", the version, the number of
+# sections, and a reserved word. Then a table of 64 byte section entries,
+# each holding a 48 byte name, an offset, and a size. Every section begins
+# on a 64 byte boundary, so that the engine may use aligned SIMD loads
+
+import math, os, struct, sys
+
+VERSION = 1
+ALIGNMENT = 64
+
+EG_NEURONS = 8
+EG_NETWORKS = [ "RPvRP" ]
+
+def read_network(fname):
+    # Each row is a quoted string of an input count, weights, then a bias
+    with open(fname) as fin:
+        rows = [line.strip().rstrip(',').strip('"') for line in fin]
+    return [list(map(float, row.split()[1:])) for row in rows if row]
+
+def f32(value):
+    return struct.unpack('<f', struct.pack('<f', value))[0]
+
+def lround(value):
+    # C's lround() and lroundf(), which round halves away from zero
+    return int(math.copysign(math.floor(abs(value) + 0.5), value))
+
+def pk_network(fname):
+
+    rows = read_network(fname)
+    layer1, outputs = rows[:32], rows[32:]
+
+    inputs = len(layer1[0]) - 1
+    weights = [lround(f32(layer1[n][i]) * 128) for i in range(inputs) for n in range(32)]
+    biases  = [lround(f32(layer1[n][-1]) * 128) for n in range(32)]
+
+    out_weights = [lround(f32(row[i]) * 64) for row in outputs for i in range(32)]
+    out_biases  = [lround(row[-1] * 128 * 64) for row in outputs]
+
+    return [
+        ('pk.inputWeights',   struct.pack('<%dh' % len(weights), *weights)),
+        ('pk.inputBiases',    struct.pack('<%dh' % len(biases), *biases)),
+        ('pk.layer1Weights',  struct.pack('<%dh' % len(out_weights), *out_weights)),
+        ('pk.layer1Biases',   struct.pack('<%di' % len(out_biases), *out_biases)),
+    ]
+
+def eg_network(name, fname):
+
+    rows = read_network(fname)
+    layer1, output = rows[:EG_NEURONS], rows[EG_NEURONS]
+
+    inputs = len(layer1[0]) - 1
+    weights = [layer1[n][i] for i in range(inputs) for n in range(EG_NEURONS)]
+    biases  = [layer1[n][-1] for n in range(EG_NEURONS)]
+
+    return [
+        ('eg.%s.inputWeights'  % name, struct.pack('<%df' % len(weights), *weights)),
+        ('eg.%s.inputBiases'   % name, struct.pack('<%df' % len(biases), *biases)),
+        ('eg.%s.layer1Weights' % name, struct.pack('<%df' % EG_NEURONS, *output[:-1])),
+        ('eg.%s.layer1Bias'    % name, struct.pack('<f', output[-1])),
+    ]
+
+def main():
+
+    here = os.path.dirname(os.path.abspath(__file__))
+    output = sys.argv[1] if len(sys.argv) > 1 else os.path.join(here, 'networks.bin')
+
+    sections = pk_network(os.path.join(here, 'pknet_224x32x2.net'))
+    for name in EG_NETWORKS:
+        sections += eg_network(name, os.path.join(here, '%s.net' % name))
+
+    offset = 16 + 64 * len(sections)
+    table, data = b'', b''
+
+    for name, blob in sections:
+        padding = -(offset + len(data)) % ALIGNMENT
+        data += b'\0' * padding
+        table += struct.pack('<48sQQ', name.encode(), offset + len(data), len(blob))
+        data += blob
+
+    with open(output, 'wb') as fout:
+        fout.write(struct.pack('<4sIII', b'ETHW', VERSION, len(sections), 0))
+        fout.write(table + data)
+
+if __name__ == '__main__':
+    main()
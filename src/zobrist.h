@@ -22,10 +22,27 @@
 
 #include "types.h"
 
-extern uint64_t ZobristKeys[32][SQUARE_NB];
-extern uint64_t ZobristEnpassKeys[FILE_NB];
-extern uint64_t ZobristCastleKeys[SQUARE_NB];
-extern uint64_t ZobristTurnKey;
+extern TABLE uint64_t ZobristKeys[32][SQUARE_NB];
+extern TABLE uint64_t ZobristEnpassKeys[FILE_NB];
+extern TABLE uint64_t ZobristCastleKeys[SQUARE_NB];
+extern TABLE uint64_t ZobristTurnKey;
+
+// Cuckoo tables of the keys of every reversible move, ie a Knight, Bishop,
+// Rook, Queen or King moving on an empty board, along with the turn key
+
+#define CUCKOO_SIZE 8192
+
+extern TABLE uint64_t CuckooKeys[CUCKOO_SIZE];
+extern TABLE uint16_t CuckooMoves[CUCKOO_SIZE];
+
+static inline int cuckooH1(uint64_t key) {
+    return key & (CUCKOO_SIZE - 1);
+}
+
+static inline int cuckooH2(uint64_t key) {
+    return (key >> 16) & (CUCKOO_SIZE - 1);
+}
 
 uint64_t rand64();
 void initZobrist();
+uint64_t polyglotKey(Board *board);